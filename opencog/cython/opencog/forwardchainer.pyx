@@ -40,13 +40,91 @@ cdef class ForwardChainer:
         self._trace_as = trace_as
 
     def do_chain(self):
-        return self.chainer.do_chain()
+        """
+        Chain till termination, without holding the GIL.
+        """
+        with nogil:
+            self.chainer.do_chain()
+
+    def run(self, max_steps, max_ms=-1):
+        """
+        Chain for at most max_steps iterations and max_ms milliseconds
+        (negative means unlimited), without holding the GIL. Can be
+        called repeatedly to resume chaining. Return True iff chaining
+        is over.
+        """
+        cdef bint finished
+        cdef int c_max_steps = max_steps
+        cdef int c_max_ms = max_ms
+        with nogil:
+            finished = self.chainer.run(c_max_steps, c_max_ms)
+        return finished
+
+    def is_finished(self):
+        return self.chainer.is_finished()
+
+    def do_chain_async(self, stream=False):
+        """
+        Chain on a worker thread and return a ChainingTask, that can be
+        awaited, polled for progress and cancelled. If stream is True
+        the results are queued as they are derived, so that progress()
+        can list them, the queue being drained by progress() only.
+        """
+        return ChainingTask(self, stream)
+
+    def cancel(self):
+        """
+        Request the chaining to stop, can be called from any thread.
+        """
+        self.chainer.cancel()
+
+    def is_cancelled(self):
+        return self.chainer.is_cancelled()
+
+    def get_iteration(self):
+        """
+        Return the number of iterations done so far.
+        """
+        return self.chainer.get_iteration()
 
     def get_results(self):
         cdef cHandle res_handle = self.chainer.get_results()
         cdef Atom result = Atom.createAtom(res_handle)
         return result
 
+    def get_results_list(self):
+        """
+        Return the results as a list, without wrapping them in a SetLink.
+        """
+        return _handles_to_atoms(self.chainer.get_results_set())
+
+    def enable_result_stream(self, enabled=True):
+        """
+        Queue results as they are derived, so that they can be consumed
+        with pop_result or iter_results. Must be called before do_chain.
+        """
+        self.chainer.get_result_stream().enable_queue(enabled)
+
+    def pop_result(self, timeout_ms=-1):
+        """
+        Pop the next streamed result as a tuple
+        (iteration, rule, origin, product), or None if there is none
+        after timeout_ms milliseconds (negative means wait till the
+        chainer terminates).
+        """
+        return _pop_result(self.chainer.get_result_stream(), timeout_ms)
+
+    def iter_results(self, timeout_ms=-1):
+        """
+        Iterate over the streamed results, till the chainer terminates
+        or no result is available after timeout_ms milliseconds.
+        """
+        while True:
+            result = self.pop_result(timeout_ms)
+            if result is None:
+                return
+            yield result
+
     def __dealloc__(self):
         del self.chainer
         self._trace_as = None
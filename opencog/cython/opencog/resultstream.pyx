@@ -0,0 +1,124 @@
+import asyncio
+import threading
+from concurrent.futures import Future
+
+from libcpp.set cimport set as cpp_set
+from opencog.atomspace cimport cHandle, Atom
+from ure cimport cResultEvent, cResultStream
+
+# Helpers shared by the forward and backward chainer wrappers to
+# consume their result streams.
+
+
+cdef object _handle_to_atom(const cHandle& h):
+    if h == h.UNDEFINED:
+        return None
+    return Atom.createAtom(h)
+
+
+cdef object _pop_result(cResultStream& stream, int timeout_ms):
+    """
+    Pop the next result of the stream, waiting at most timeout_ms
+    milliseconds (for ever if negative). Return a tuple
+
+    (iteration, rule, origin, product)
+
+    where rule is None for the backward chainer, origin is the source
+    (FC) or the forward chaining strategy (BC) that produced the
+    product, or None if no result is available.
+    """
+    cdef cResultEvent re
+    cdef bint popped
+    with nogil:
+        popped = stream.pop(re, timeout_ms)
+    if not popped:
+        return None
+    return (re.iteration, _handle_to_atom(re.rule),
+            _handle_to_atom(re.origin), _handle_to_atom(re.product))
+
+
+cdef object _handles_to_atoms(cpp_set[cHandle] handles):
+    """
+    Return a list of the atoms of a set of handles.
+    """
+    atoms = []
+    for h in handles:
+        atoms.append(Atom.createAtom(h))
+    return atoms
+
+
+class ChainingTask(object):
+    """
+    Chaining running on a worker thread, as returned by the
+    do_chain_async method of the forward and backward chainer
+    wrappers. The GIL is released while chaining, so that other
+    Python threads keep running.
+
+    It can be waited on with result(), or awaited from a coroutine,
+    in which case it resolves to the list of results. progress() can
+    be polled in the meantime, and cancel() stops the chaining at the
+    end of the current step, the result being then the list of results
+    found so far.
+
+    The result stream of the chainer is only enabled if stream is
+    True, as its queue grows till drained by progress().
+    """
+
+    def __init__(self, chainer, stream=False):
+        self._chainer = chainer
+        self._stream = stream
+        self._results = []
+        self._lock = threading.Lock()
+        self.future = Future()
+        if stream:
+            chainer.enable_result_stream()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+        self._thread.start()
+
+    def _run(self):
+        if not self.future.set_running_or_notify_cancel():
+            return
+        try:
+            self._chainer.do_chain()
+            self.future.set_result(self._chainer.get_results_list())
+        except BaseException as e:
+            self.future.set_exception(e)
+
+    def cancel(self):
+        """
+        Request the chaining to stop.
+        """
+        self._chainer.cancel()
+
+    def cancelled(self):
+        return self._chainer.is_cancelled()
+
+    def done(self):
+        return self.future.done()
+
+    def result(self, timeout=None):
+        """
+        Wait at most timeout seconds (for ever if None) for the chaining
+        to terminate and return the list of its results.
+        """
+        return self.future.result(timeout)
+
+    def progress(self):
+        """
+        Return a tuple (iterations, results) of the number of iterations
+        done so far and the list of results derived so far. Unless the
+        task streams its results, they are only listed once done.
+        """
+        with self._lock:
+            if self._stream:
+                while True:
+                    result = self._chainer.pop_result(0)
+                    if result is None:
+                        break
+                    self._results.append(result[3])
+            elif self.future.done() and self.future.exception() is None:
+                self._results = self.future.result()
+            return (self._chainer.get_iteration(), list(self._results))
+
+    def __await__(self):
+        return asyncio.wrap_future(self.future).__await__()
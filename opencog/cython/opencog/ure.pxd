@@ -4,6 +4,21 @@ from opencog.atomspace cimport cHandle, cAtomSpace
 from opencog.logger cimport cLogger
 
 
+cdef extern from "opencog/ure/ResultStream.h" namespace "opencog":
+    cdef cppclass cResultEvent "opencog::ResultEvent":
+        unsigned iteration
+        cHandle rule
+        cHandle origin
+        cHandle product
+
+    cdef cppclass cResultStream "opencog::ResultStream":
+        void enable_queue(bint enabled)
+        bint is_queue_enabled()
+        bint try_pop(cResultEvent& re)
+        bint pop(cResultEvent& re, int timeout_ms) nogil
+        bint is_closed()
+
+
 cdef extern from "opencog/ure/forwardchainer/ForwardChainer.h" namespace "opencog":
     cdef cppclass cForwardChainer "opencog::ForwardChainer":
         cForwardChainer(cAtomSpace& kb_as,
@@ -14,8 +29,15 @@ cdef extern from "opencog/ure/forwardchainer/ForwardChainer.h" namespace "openco
                         cAtomSpace* trace_as,
                         const vector[cHandle]& focus_set) except +
 
-        void do_chain() except +
+        void do_chain() nogil except +
+        bint run(int max_steps, int max_ms) nogil except +
+        bint is_finished() const
+        void cancel()
+        bint is_cancelled() const
+        int get_iteration() const
         cHandle get_results() const
+        set[cHandle] get_results_set() const
+        cResultStream& get_result_stream()
 
 
 cdef extern from "opencog/ure/backwardchainer/Fitness.h" namespace "opencog::BITNodeFitness":
@@ -68,7 +90,32 @@ cdef extern from "opencog/ure/backwardchainer/BackwardChainer.h" namespace "open
                         cAtomSpace* control_as,
                         const cHandle& focus_set) except +
 
-        void do_chain() except +
+        void do_chain() nogil except +
+        bint run(int max_steps, int max_ms) nogil except +
+        bint is_finished() const
+        void cancel()
+        bint is_cancelled() const
+        int get_iteration() const
+        cHandle get_results() const
+        set[cHandle] get_results_set() const
+        cResultStream& get_result_stream()
+
+
+cdef extern from "opencog/ure/backwardchainer/BatchBackwardChainer.h" namespace "opencog":
+    cdef cppclass cBatchBackwardChainer "opencog::BatchBackwardChainer":
+        cBatchBackwardChainer(cAtomSpace& _as,
+                              const cHandle& rbs,
+                              const vector[cHandle]& targets,
+                              const vector[cHandle]& vardecls,
+                              cAtomSpace* control_as) except +
+
+        void set_jobs(unsigned jobs)
+        void set_maximum_iterations(int mi)
+        void set_maximum_time(double mt)
+        void do_chain() nogil except +
+        void cancel()
+        bint is_cancelled() const
+        size_t size() const
         cHandle get_results() const
 
 
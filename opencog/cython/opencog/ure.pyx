@@ -5,6 +5,7 @@
 # Note that the ordering of include statements may influence whether
 # things work or not
 
+include "resultstream.pyx"
 include "forwardchainer.pyx"
 include "backwardchainer.pyx"
 include "logger.pyx"
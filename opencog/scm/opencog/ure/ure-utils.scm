@@ -28,11 +28,24 @@
 ;; -- ure-set-complexity-penalty -- Set the URE:complexity-penalty parameter
 ;; -- ure-set-jobs -- Set the URE:jobs parameter
 ;; -- ure-set-expansion-pool-size -- Set the URE:expansion-pool-size parameter
+;; -- ure-set-maximum-time -- Set the URE:maximum-time parameter
+;; -- ure-set-maximum-atoms-created -- Set the URE:maximum-atoms-created parameter
+;; -- ure-set-maximum-memory -- Set the URE:maximum-memory parameter
+;; -- ure-set-trace-sampling -- Set the URE:trace-sampling parameter
+;; -- ure-set-trace-async -- Set the URE:trace-async parameter
+;; -- ure-set-rule-tv-learning -- Set the URE:rule-tv-learning parameter
+;; -- ure-set-rule-tv-persistence -- Set the URE:rule-tv-persistence parameter
 ;; -- ure-set-fc-retry-exhausted-sources -- Set the URE:FC:retry-exhausted-sources parameter
 ;; -- ure-set-fc-full-rule-application -- Set the URE:FC:full-rule-application parameter
+;; -- ure-set-fc-results-only -- Set the URE:FC:results-only parameter
 ;; -- ure-set-bc-maximum-bit-size -- Set the URE:BC:maximum-bit-size
+;; -- ure-set-bc-bit-low-watermark -- Set the URE:BC:bit-low-watermark
 ;; -- ure-set-bc-mm-complexity-penalty -- Set the URE:BC:MM:complexity-penalty
 ;; -- ure-set-bc-mm-compressiveness -- Set the URE:BC:MM:compressiveness
+;; -- ure-set-bc-fulfillment-jobs -- Set the URE:BC:fulfillment-jobs
+;; -- ure-set-bc-fulfillment-queue-size -- Set the URE:BC:fulfillment-queue-size
+;; -- ure-set-bc-fulfillment-cache -- Set the URE:BC:fulfillment-cache
+;; -- ure-set-bc-goal-tabling -- Set the URE:BC:goal-tabling
 ;; -- ure-define-rbs -- Create a rbs that runs for a particular number of
 ;;                      iterations.
 ;; -- ure-logger-set-level! -- Set level of the URE logger
@@ -94,8 +107,18 @@
                  (complexity-penalty *unspecified*)
                  (jobs *unspecified*)
                  (expansion-pool-size *unspecified*)
+                 (maximum-time *unspecified*)
+                 (maximum-atoms-created *unspecified*)
+                 (maximum-memory *unspecified*)
+                 (rule-tv-learning *unspecified*)
+                 (rule-tv-persistence *unspecified*)
+                 (trace-sampling *unspecified*)
+                 (trace-async *unspecified*)
                  (fc-retry-exhausted-sources *unspecified*)
-                 (fc-full-rule-application *unspecified*))
+                 (fc-full-rule-application *unspecified*)
+                 (fc-results-only *unspecified*)
+                 (results-anchor (List))
+                 (results-as #f))
 "
   Forward Chainer call.
 
@@ -108,8 +131,18 @@
                  #:complexity-penalty cp
                  #:jobs jb
                  #:expansion-pool-size esp
+                 #:maximum-time mt
+                 #:maximum-atoms-created mac
+                 #:maximum-memory mm
+                 #:rule-tv-learning rtl
+                 #:rule-tv-persistence rtp
+                 #:trace-sampling ts
+                 #:trace-async ta
                  #:fc-retry-exhausted-sources res
-                 #:fc-full-rule-application fra)
+                 #:fc-full-rule-application fra
+                 #:fc-results-only ro
+                 #:results-anchor ra
+                 #:results-as ras)
 
   rbs: ConceptNode representing a rulebase.
 
@@ -143,6 +176,29 @@
        the forward chainer), but also then the selection is more costly.
        Negative or null means unlimited (not recommended).
 
+  mt: [optional, default=-1] Wall-clock time budget in seconds.
+      Negative means unlimited.
+
+  mac: [optional, default=-1] Maximum number of atoms created in the
+       knowledge base. Negative means unlimited.
+
+  mm: [optional, default=-1] Maximum memory usage of the process in
+      megabytes. Negative means unlimited.
+
+  rtl: [optional, default=#f] Whether the rule TVs are updated during
+       chaining, according to whether their applications succeed or
+       fail, so that rule selection adapts within a run.
+
+  rtp: [optional, default=#f] Whether the rule TVs updated during
+       chaining are written back to the rule base afterwards, so that
+       subsequent runs start from them.
+
+  ts: [optional, default=1] Fraction, within [0, 1], of the inferences
+      recorded in the trace atomspace.
+
+  ta: [optional, default=#t] Whether the traces are written to the
+      trace atomspace in the background.
+
   res: [optional, default=#f] Whether exhausted sources should be
        retried. A source is exhausted if all its valid rules (so that at
        least one rule premise unifies with the source) have been applied to
@@ -154,6 +210,21 @@
        entire atomspace, not just the source. This can be convienient if
        the goal is to rapidly achieve inference closure.
 
+  ro: [optional, default=#f] Whether only the results are kept in
+      memory, rather than a record of each inference step. Recommended
+      for long runs. Does not affect the trace atomspace.
+
+  ra: [optional] Anchor, such as (Anchor \"fc-results\"), to which
+      results are attached, in the form of (Member <result> ra).
+
+  ras: [optional] AtomSpace where results are attached to ra as soon
+       as they are derived. This allows another thread to consume
+       results while forward chaining is still running, for instance
+       with (cog-incoming-by-type ra 'MemberLink) with ras as current
+       atomspace. If not provided, results are attached to ra in the
+       current atomspace once forward chaining is over, so that the
+       member links do not alter the course of forward chaining.
+
   Note that the defaults of the optional arguments are not determined
   here (although they attempt to be documented here).  That is the case
   in order not to overwrite existing parameters set by
@@ -172,15 +243,34 @@
       (ure-set-jobs rbs jobs))
   (if (not (unspecified? expansion-pool-size))
       (ure-set-expansion-pool-size rbs expansion-pool-size))
+  (if (not (unspecified? maximum-time))
+      (ure-set-maximum-time rbs maximum-time))
+  (if (not (unspecified? maximum-atoms-created))
+      (ure-set-maximum-atoms-created rbs maximum-atoms-created))
+  (if (not (unspecified? maximum-memory))
+      (ure-set-maximum-memory rbs maximum-memory))
+  (if (not (unspecified? rule-tv-learning))
+      (ure-set-rule-tv-learning rbs rule-tv-learning))
+  (if (not (unspecified? rule-tv-persistence))
+      (ure-set-rule-tv-persistence rbs rule-tv-persistence))
+  (if (not (unspecified? trace-sampling))
+      (ure-set-trace-sampling rbs trace-sampling))
+  (if (not (unspecified? trace-async))
+      (ure-set-trace-async rbs trace-async))
   (if (not (unspecified? fc-retry-exhausted-sources))
       (ure-set-fc-retry-exhausted-sources rbs fc-retry-exhausted-sources))
   (if (not (unspecified? fc-full-rule-application))
       (ure-set-fc-full-rule-application rbs fc-full-rule-application))
+  (if (not (unspecified? fc-results-only))
+      (ure-set-fc-results-only rbs fc-results-only))
 
   ;; Defined optional atomspaces and call the forward chainer
   (let* ((trace-enabled (cog-atomspace? trace-as))
-         (tas (if trace-enabled trace-as (cog-atomspace))))
-    (cog-mandatory-args-fc rbs source vardecl trace-enabled tas focus-set)))
+         (tas (if trace-enabled trace-as (cog-atomspace)))
+         (results-enabled (cog-atomspace? results-as))
+         (ras (if results-enabled results-as (cog-atomspace))))
+    (cog-mandatory-args-fc rbs source vardecl trace-enabled tas focus-set
+                           results-anchor results-enabled ras)))
 
 (define* (cog-bc rbs target
                  #:key
@@ -193,9 +283,23 @@
                  (complexity-penalty *unspecified*)
                  (jobs *unspecified*)
                  (expansion-pool-size *unspecified*)
+                 (maximum-time *unspecified*)
+                 (maximum-atoms-created *unspecified*)
+                 (maximum-memory *unspecified*)
+                 (rule-tv-learning *unspecified*)
+                 (rule-tv-persistence *unspecified*)
+                 (trace-sampling *unspecified*)
+                 (trace-async *unspecified*)
                  (bc-maximum-bit-size *unspecified*)
+                 (bc-bit-low-watermark *unspecified*)
                  (bc-mm-complexity-penalty *unspecified*)
-                 (bc-mm-compressiveness *unspecified*))
+                 (bc-mm-compressiveness *unspecified*)
+                 (bc-fulfillment-jobs *unspecified*)
+                 (bc-fulfillment-queue-size *unspecified*)
+                 (bc-fulfillment-cache *unspecified*)
+                 (bc-goal-tabling *unspecified*)
+                 (results-anchor (List))
+                 (results-as #f))
 "
   Backward Chainer call.
 
@@ -209,9 +313,23 @@
                  #:complexity-penalty cp
                  #:jobs jb
                  #:expansion-pool-size esp
+                 #:maximum-time mt
+                 #:maximum-atoms-created mac
+                 #:maximum-memory mm
+                 #:rule-tv-learning rtl
+                 #:rule-tv-persistence rtp
+                 #:trace-sampling ts
+                 #:trace-async ta
                  #:bc-maximum-bit-size mbs
+                 #:bc-bit-low-watermark blw
                  #:bc-mm-complexity-penalty mcp
-                 #:bc-mm-compressiveness mc)
+                 #:bc-mm-compressiveness mc
+                 #:bc-fulfillment-jobs fj
+                 #:bc-fulfillment-queue-size fqs
+                 #:bc-fulfillment-cache fc
+                 #:bc-goal-tabling gt
+                 #:results-anchor ra
+                 #:results-as ras)
 
   rbs: ConceptNode representing a rulebase.
 
@@ -246,9 +364,37 @@
        the forward chainer), but also then the selection is more costly.
        Negative or null means unlimited (not recommended).
 
+  mt: [optional, default=-1] Wall-clock time budget in seconds.
+      Negative means unlimited.
+
+  mac: [optional, default=-1] Maximum number of atoms created in the
+       knowledge base. Negative means unlimited.
+
+  mm: [optional, default=-1] Maximum memory usage of the process in
+      megabytes. Negative means unlimited.
+
+  rtl: [optional, default=#f] Whether the rule TVs are updated during
+       chaining, according to whether their applications succeed or
+       fail, so that rule selection adapts within a run.
+
+  rtp: [optional, default=#f] Whether the rule TVs updated during
+       chaining are written back to the rule base afterwards, so that
+       subsequent runs start from them.
+
+  ts: [optional, default=1] Fraction, within [0, 1], of the inference
+      trees recorded in the trace atomspace, along with their
+      expansions and proofs.
+
+  ta: [optional, default=#t] Whether the traces are written to the
+      trace atomspace in the background.
+
   mbs: [optional, default=-1] Maximum size of the inference tree pool
        to evolve. Negative means unlimited.
 
+  blw: [optional, default=1] When the inference tree pool exceeds its
+       maximum size, inference trees are evicted till its size gets down
+       to mbs * blw. A value below 1 avoids evicting at every iteration.
+
   mcp: [optional, default=0] Complexity penalty applied to the control
        rules during Bayesian Model Averaging.
 
@@ -256,6 +402,38 @@
       control rules (how well a control rule can explain data outside of its
       context).
 
+  fj: [optional, default=0] Number of workers running the forward
+      chaining strategies in the background, while the inference tree
+      keeps being expanded. 0 means they are run right after expansion.
+
+  fqs: [optional, default=16] Maximum number of forward chaining
+       strategies waiting to be run by the workers, beyond which the
+       expansion waits.
+
+  fc: [optional, default=#f] Whether the results of running a forward
+      chaining strategy are cached, so that it is not run again unless
+      the knowledge base has changed in the meantime. Only atom
+      insertions and the chainer's own fulfillments are noticed, so
+      it should only be enabled if nothing else modifies the TVs of
+      the knowledge base while chaining, as a cache hit does not
+      recalculate the TVs of the results.
+
+  gt: [optional, default=#f] Whether the rules that have expanded a
+      subgoal, and whether they have led to proofs, are shared across
+      the inference trees containing that subgoal, so that it is not
+      searched again.
+
+  ra: [optional] Anchor, such as (Anchor \"bc-results\"), to which
+      results are attached, in the form of (Member <result> ra).
+
+  ras: [optional] AtomSpace where results are attached to ra as soon
+       as they are derived. This allows another thread to consume
+       results while backward chaining is still running, for instance
+       with (cog-incoming-by-type ra 'MemberLink) with ras as current
+       atomspace. If not provided, results are attached to ra in the
+       current atomspace once backward chaining is over, so that the
+       member links do not alter the course of backward chaining.
+
   Note that the defaults of the optional arguments are not determined
   here (although they attempt to be documented here).  That is the case
   in order not to overwrite existing parameters set by
@@ -274,20 +452,95 @@
       (ure-set-jobs rbs jobs))
   (if (not (unspecified? expansion-pool-size))
       (ure-set-expansion-pool-size rbs expansion-pool-size))
+  (if (not (unspecified? maximum-time))
+      (ure-set-maximum-time rbs maximum-time))
+  (if (not (unspecified? maximum-atoms-created))
+      (ure-set-maximum-atoms-created rbs maximum-atoms-created))
+  (if (not (unspecified? maximum-memory))
+      (ure-set-maximum-memory rbs maximum-memory))
+  (if (not (unspecified? rule-tv-learning))
+      (ure-set-rule-tv-learning rbs rule-tv-learning))
+  (if (not (unspecified? rule-tv-persistence))
+      (ure-set-rule-tv-persistence rbs rule-tv-persistence))
+  (if (not (unspecified? trace-sampling))
+      (ure-set-trace-sampling rbs trace-sampling))
+  (if (not (unspecified? trace-async))
+      (ure-set-trace-async rbs trace-async))
   (if (not (unspecified? bc-maximum-bit-size))
       (ure-set-bc-maximum-bit-size rbs bc-maximum-bit-size))
+  (if (not (unspecified? bc-bit-low-watermark))
+      (ure-set-bc-bit-low-watermark rbs bc-bit-low-watermark))
   (if (not (unspecified? bc-mm-complexity-penalty))
       (ure-set-bc-mm-complexity-penalty rbs bc-mm-complexity-penalty))
   (if (not (unspecified? bc-mm-compressiveness))
       (ure-set-bc-mm-compressiveness rbs bc-mm-compressiveness))
+  (if (not (unspecified? bc-fulfillment-jobs))
+      (ure-set-bc-fulfillment-jobs rbs bc-fulfillment-jobs))
+  (if (not (unspecified? bc-fulfillment-queue-size))
+      (ure-set-bc-fulfillment-queue-size rbs bc-fulfillment-queue-size))
+  (if (not (unspecified? bc-fulfillment-cache))
+      (ure-set-bc-fulfillment-cache rbs bc-fulfillment-cache))
+  (if (not (unspecified? bc-goal-tabling))
+      (ure-set-bc-goal-tabling rbs bc-goal-tabling))
 
   ;; Defined optional atomspaces and call the backward chainer
   (let* ((trace-enabled (cog-atomspace? trace-as))
          (control-enabled (cog-atomspace? control-as))
          (tas (if trace-enabled trace-as (cog-atomspace)))
-         (cas (if control-enabled control-as (cog-atomspace))))
+         (cas (if control-enabled control-as (cog-atomspace)))
+         (results-enabled (cog-atomspace? results-as))
+         (ras (if results-enabled results-as (cog-atomspace))))
     (cog-mandatory-args-bc rbs target vardecl
-                           trace-enabled tas control-enabled cas focus-set)))
+                           trace-enabled tas control-enabled cas focus-set
+                           results-anchor results-enabled ras)))
+
+(define* (cog-bc-batch rbs targets
+                       #:key
+                       (vardecls '())
+                       (control-as #f)
+                       (jobs 0)
+                       (maximum-iterations -1)
+                       (maximum-time -1))
+"
+  Batch Backward Chainer call. Run a backward chainer query per
+  target, in parallel, over the same rule base.
+
+  Usage: (cog-bc-batch rbs targets
+                       #:vardecls vds
+                       #:control-as cas
+                       #:jobs jb
+                       #:maximum-iterations mi
+                       #:maximum-time mt)
+
+  rbs: ConceptNode representing a rulebase.
+
+  targets: List of targets to proof.
+
+  vds: [optional] List of variable declarations, one per target, an
+       empty (List) for targets without variables.
+
+  cas: [optional] AtomSpace storing inference control rules.
+
+  jb: [optional, default=0] Number of queries to run in parallel. 0
+      means as many as hardware threads.
+
+  mi: [optional, default=-1] Maximum number of iterations of each
+      query. Negative means that of the rulebase.
+
+  mt: [optional, default=-1] Wall-clock time budget in seconds of
+      each query. Negative means that of the rulebase.
+
+  Return a ListLink of SetLinks, the results of each target, in the
+  order of the targets.
+
+  Unlike cog-bc, the budgets of the queries do not overwrite the
+  parameters of the rulebase.
+"
+  (let* ((control-enabled (cog-atomspace? control-as))
+         (cas (if control-enabled control-as (cog-atomspace))))
+    (cog-mandatory-args-bc-batch rbs targets vardecls control-enabled cas
+                                 jobs maximum-iterations
+                                 (exact->inexact maximum-time))))
 
 (set-procedure-property! cog-ure-logger 'documentation
 "
@@ -295,6 +548,28 @@
     Return the ure logger.
 ")
 
+(set-procedure-property! cog-ure-save-rule-base 'documentation
+"
+ cog-ure-save-rule-base RBS FILENAME
+    Write the rule base RBS, its rules, their definitions and TVs, and
+    its parameters, to the binary file FILENAME. Return RBS.
+
+    Loading it with cog-ure-load-rule-base is much faster than
+    evaluating the scheme files defining the rule base, as the
+    configuration does not need to be fetched from the atomspace.
+")
+
+(set-procedure-property! cog-ure-load-rule-base 'documentation
+"
+ cog-ure-load-rule-base FILENAME
+    Load in the current atomspace the rule base written in FILENAME
+    by cog-ure-save-rule-base, and return it. The first chainer over
+    that rule base then starts without querying the atomspace.
+
+    Parameters already set in the current atomspace are left as they
+    are, and the file is refused if any of them has another value.
+")
+
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;; URE Configuration Helpers ;;
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
@@ -848,6 +1123,108 @@
 "
   (ure-set-num-parameter rbs "URE:expansion-pool-size" value))
 
+(define (ure-set-maximum-time rbs value)
+"
+  Set the URE:maximum-time parameter of a given RBS, the wall-clock
+  time budget in seconds. Negative means unlimited.
+
+  ExecutionLink
+    SchemaNode \"URE:maximum-time\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:maximum-time" value))
+
+(define (ure-set-maximum-atoms-created rbs value)
+"
+  Set the URE:maximum-atoms-created parameter of a given RBS, the
+  maximum number of atoms created in the knowledge base. Negative
+  means unlimited.
+
+  ExecutionLink
+    SchemaNode \"URE:maximum-atoms-created\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:maximum-atoms-created" value))
+
+(define (ure-set-maximum-memory rbs value)
+"
+  Set the URE:maximum-memory parameter of a given RBS, the maximum
+  memory usage of the process in megabytes. Negative means unlimited.
+
+  ExecutionLink
+    SchemaNode \"URE:maximum-memory\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:maximum-memory" value))
+
+(define (ure-set-trace-sampling rbs value)
+"
+  Set the URE:trace-sampling parameter of a given RBS, the fraction,
+  within [0, 1], of inferences (forward chainer) or inference trees
+  (backward chainer) to record in the trace atomspace.
+
+  ExecutionLink
+    SchemaNode \"URE:trace-sampling\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:trace-sampling" value))
+
+(define (ure-set-trace-async rbs value)
+"
+  Set the URE:trace-async parameter of a given RBS, whether inference
+  traces are written to the trace atomspace in the background.
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:trace-async\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:trace-async" value))
+
+(define (ure-set-rule-tv-learning rbs value)
+"
+  Set the URE:rule-tv-learning parameter of a given RBS, whether the
+  TVs of the rules are updated during chaining, according to whether
+  their applications succeed or fail.
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:rule-tv-learning\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:rule-tv-learning" value))
+
+(define (ure-set-rule-tv-persistence rbs value)
+"
+  Set the URE:rule-tv-persistence parameter of a given RBS, whether
+  the rule TVs updated during chaining are written back to the
+  MemberLinks of the rule base once chaining is over.
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:rule-tv-persistence\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:rule-tv-persistence" value))
+
 (define (ure-set-fc-retry-exhausted-sources rbs value)
 "
   Set the URE:FC:retry-exhausted-sources parameter of a given RBS
@@ -874,6 +1251,19 @@
 "
   (ure-set-fuzzy-bool-parameter rbs "URE:FC:full-rule-application" value))
 
+(define (ure-set-fc-results-only rbs value)
+"
+  Set the URE:FC:results-only parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:FC:results-only\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:FC:results-only" value))
+
 (define (ure-set-bc-maximum-bit-size rbs value)
 "
   Set the URE:BC:maximum-bit-size parameter of a given RBS
@@ -887,6 +1277,19 @@
 "
   (ure-set-num-parameter rbs "URE:BC:maximum-bit-size" value))
 
+(define (ure-set-bc-bit-low-watermark rbs value)
+"
+  Set the URE:BC:bit-low-watermark parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:bit-low-watermark\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:bit-low-watermark" value))
+
 (define (ure-set-bc-mm-complexity-penalty rbs value)
 "
   Set the URE:BC:MM:complexity-penalty parameter of a given RBS
@@ -913,6 +1316,58 @@
 "
   (ure-set-num-parameter rbs "URE:BC:MM:compressiveness" value))
 
+(define (ure-set-bc-fulfillment-jobs rbs value)
+"
+  Set the URE:BC:fulfillment-jobs parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:fulfillment-jobs\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:fulfillment-jobs" value))
+
+(define (ure-set-bc-fulfillment-queue-size rbs value)
+"
+  Set the URE:BC:fulfillment-queue-size parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:fulfillment-queue-size\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:fulfillment-queue-size" value))
+
+(define (ure-set-bc-fulfillment-cache rbs value)
+"
+  Set the URE:BC:fulfillment-cache parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:BC:fulfillment-cache\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:BC:fulfillment-cache" value))
+
+(define (ure-set-bc-goal-tabling rbs value)
+"
+  Set the URE:BC:goal-tabling parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:BC:goal-tabling\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:BC:goal-tabling" value))
+
 (define-public (ure-define-rbs rbs iteration)
 "
   Transforms the atom into a node that represents a rulebase and returns it.
@@ -1279,6 +1734,7 @@
   (export
           cog-fc
           cog-bc
+          cog-bc-batch
           cog-ure-logger
           ure-define-add-rule
           ure-add-rule-alias
@@ -1299,11 +1755,24 @@
           ure-set-complexity-penalty
           ure-set-jobs
           ure-set-expansion-pool-size
+          ure-set-maximum-time
+          ure-set-maximum-atoms-created
+          ure-set-maximum-memory
+          ure-set-trace-sampling
+          ure-set-trace-async
+          ure-set-rule-tv-learning
+          ure-set-rule-tv-persistence
           ure-set-fc-retry-exhausted-sources
           ure-set-fc-full-rule-application
+          ure-set-fc-results-only
           ure-set-bc-maximum-bit-size
+          ure-set-bc-bit-low-watermark
           ure-set-bc-mm-complexity-penalty
           ure-set-bc-mm-compressiveness
+          ure-set-bc-fulfillment-jobs
+          ure-set-bc-fulfillment-queue-size
+          ure-set-bc-fulfillment-cache
+          ure-set-bc-goal-tabling
           ure-define-rbs
           ure-get-forward-rule
           ure-logger-set-level!
@@ -21,13 +21,27 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include "BetaDistribution.h"
 #include "URELogger.h"
 
+#include <opencog/util/oc_assert.h>
 #include <opencog/atoms/truthvalue/SimpleTruthValue.h>
 
 namespace opencog {
 
+const double BetaDistribution::cdf_quantum = 1e-6;
+const size_t BetaDistribution::cdf_cache_capacity = 4096;
+
+// Cache of cdf tables, indexed by bins and quantized alpha and beta
+typedef std::tuple<int, long long, long long> CDFKey;
+static std::map<CDFKey, std::vector<double>> cdf_cache;
+static std::mutex cdf_cache_mutex;
+
 BetaDistribution::BetaDistribution(const TruthValuePtr& tv,
                                    double p_alpha, double p_beta)
 	// TODO should be replaced by tv->get_mode() once implemented
@@ -40,7 +54,64 @@ BetaDistribution::BetaDistribution(double pos_count, double count,
 
 double BetaDistribution::operator()(RandGen& rng) const
 {
-	return boost::math::ibeta_inv(alpha(), beta(), rng.randdouble());
+	double x = gamma_sample(alpha(), rng),
+		y = gamma_sample(beta(), rng);
+	// Both may underflow with very small shapes
+	return 0.0 < x + y ? x / (x + y) : mean();
+}
+
+void BetaDistribution::sample(const std::vector<Parameters>& params,
+                              std::vector<double>& samples,
+                              RandGen& rng)
+{
+	samples.resize(params.size());
+	for (size_t i = 0; i < params.size(); i++) {
+		double a = params[i].first, b = params[i].second,
+			x = gamma_sample(a, rng),
+			y = gamma_sample(b, rng);
+		samples[i] = 0.0 < x + y ? x / (x + y) : a / (a + b);
+	}
+}
+
+double BetaDistribution::gamma_sample(double shape, RandGen& rng)
+{
+	OC_ASSERT(0.0 < shape, "shape = %g, should be greater than zero", shape);
+
+	// Gamma(shape) = Gamma(shape + 1) * U^(1/shape)
+	if (shape < 1.0) {
+		double u;
+		do { u = rng.randdouble(); } while (u <= 0.0);
+		return gamma_sample(shape + 1.0, rng) * std::pow(u, 1.0 / shape);
+	}
+
+	double d = shape - 1.0 / 3.0,
+		c = 1.0 / std::sqrt(9.0 * d);
+	while (true) {
+		double x, v;
+		do {
+			x = normal_sample(rng);
+			v = 1.0 + c * x;
+		} while (v <= 0.0);
+		v = v * v * v;
+		double u = rng.randdouble(),
+			x2 = x * x;
+		// Squeeze, then exact acceptance test
+		if (u < 1.0 - 0.0331 * x2 * x2)
+			return d * v;
+		if (0.0 < u and std::log(u) < 0.5 * x2 + d * (1.0 - v + std::log(v)))
+			return d * v;
+	}
+}
+
+double BetaDistribution::normal_sample(RandGen& rng)
+{
+	double u, v, s;
+	do {
+		u = 2.0 * rng.randdouble() - 1.0;
+		v = 2.0 * rng.randdouble() - 1.0;
+		s = u * u + v * v;
+	} while (s >= 1.0 or s == 0.0);
+	return u * std::sqrt(-2.0 * std::log(s) / s);
 }
 
 double BetaDistribution::alpha() const
@@ -64,6 +135,43 @@ double BetaDistribution::variance() const
 }
 
 std::vector<double> BetaDistribution::cdf(int bins) const
+{
+	// Beyond 2^62 quanta the rounding would overflow
+	double qalpha = alpha() / cdf_quantum, qbeta = beta() / cdf_quantum,
+		max_quanta = std::ldexp(1.0, 62);
+	if (not (qalpha < max_quanta and qbeta < max_quanta))
+		return compute_cdf(bins);
+
+	CDFKey key(bins, std::llround(qalpha), std::llround(qbeta));
+	{
+		std::lock_guard<std::mutex> lock(cdf_cache_mutex);
+		auto it = cdf_cache.find(key);
+		if (it != cdf_cache.end())
+			return it->second;
+	}
+
+	std::vector<double> table = compute_cdf(bins);
+
+	std::lock_guard<std::mutex> lock(cdf_cache_mutex);
+	if (cdf_cache_capacity <= cdf_cache.size())
+		cdf_cache.clear();
+	cdf_cache.emplace(key, table);
+	return table;
+}
+
+size_t BetaDistribution::cdf_cache_size()
+{
+	std::lock_guard<std::mutex> lock(cdf_cache_mutex);
+	return cdf_cache.size();
+}
+
+void BetaDistribution::clear_cdf_cache()
+{
+	std::lock_guard<std::mutex> lock(cdf_cache_mutex);
+	cdf_cache.clear();
+}
+
+std::vector<double> BetaDistribution::compute_cdf(int bins) const
 {
 	std::vector<double> cdf;
 	for (int x_idx = 0; x_idx < bins; x_idx++) {
@@ -50,10 +50,32 @@ public:
 	                 double prior_alpha=1.0, double prior_beta=1.0);
 
 	/**
-	 * Return a random number drawn from that beta distribution
+	 * Return a random number drawn from that beta distribution.
+	 *
+	 * It is obtained as X / (X + Y), where X and Y are drawn from
+	 * gamma distributions of shapes alpha and beta respectively, see
+	 * gamma_sample.
 	 */
 	double operator()(RandGen& rng=randGen()) const;
 
+	/**
+	 * Draw one sample from each beta distribution of parameters
+	 * (alpha, beta) in params, and place them in samples, in the
+	 * same order.
+	 */
+	typedef std::pair<double, double> Parameters;
+	static void sample(const std::vector<Parameters>& params,
+	                   std::vector<double>& samples,
+	                   RandGen& rng=randGen());
+
+	/**
+	 * Return a random number drawn from a gamma distribution of the
+	 * given shape (and scale 1), using Marsaglia and Tsang's method.
+	 * Shapes below 1 are boosted by 1 and corrected with a uniform
+	 * draw.
+	 */
+	static double gamma_sample(double shape, RandGen& rng=randGen());
+
 	/**
 	 * Return the alpha parameter of the distribution
 	 */
@@ -85,9 +107,28 @@ public:
 	 *
 	 * The cdf at the origin is ignored because it is always 0. The
 	 * last one is always 1 but is included for completeness.
+	 *
+	 * Tables are memoized per bins and (alpha, beta), quantized to
+	 * cdf_quantum, as the same TVs keep being discretized by the
+	 * action selection. Parameters too large to be quantized, due to
+	 * huge counts, are not memoized.
 	 */
 	std::vector<double> cdf(int bins) const;
 
+	// Step to which alpha and beta are rounded to look up the cdf
+	// table cache
+	static const double cdf_quantum;
+
+	// Maximum number of cdf tables in the cache, beyond which it is
+	// cleared
+	static const size_t cdf_cache_capacity;
+
+	/**
+	 * Number of cdf tables in the cache, and clear it.
+	 */
+	static size_t cdf_cache_size();
+	static void clear_cdf_cache();
+
 	/**
 	 * Generate a vector of the pdf of regularly spaced right-end
 	 * points, specifically
@@ -125,6 +166,17 @@ public:
 
 private:
 	boost::math::beta_distribution<double> _beta_distribution;
+
+	/**
+	 * Calculate the cdf vector, see cdf.
+	 */
+	std::vector<double> compute_cdf(int bins) const;
+
+	/**
+	 * Draw a standard normal random number, using Marsaglia's polar
+	 * method.
+	 */
+	static double normal_sample(RandGen& rng);
 };
 
 // Helpers
@@ -0,0 +1,65 @@
+/*
+ * CancellationToken.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_CANCELLATIONTOKEN_H_
+#define _OPENCOG_CANCELLATIONTOKEN_H_
+
+#include <atomic>
+#include <memory>
+
+namespace opencog
+{
+
+/**
+ * Flag requesting chainers to stop, that can be raised from any
+ * thread.
+ *
+ * Chainers check it between steps, as part of their termination
+ * criteria, as well as inside the loops that may take long, such as
+ * the search of the valid rules. A token can be shared by several
+ * chainers, so that they can all be cancelled at once, see
+ * BatchBackwardChainer.
+ *
+ * Once cancelled, a token remains cancelled.
+ */
+class CancellationToken
+{
+public:
+	CancellationToken();
+
+	/**
+	 * Request the chainers using that token to stop.
+	 */
+	void cancel();
+
+	/**
+	 * Return true iff cancel() has been called.
+	 */
+	bool is_cancelled() const;
+
+private:
+	std::atomic<bool> _cancelled;
+};
+
+typedef std::shared_ptr<CancellationToken> CancellationTokenPtr;
+
+} // namespace opencog
+
+#endif /* _OPENCOG_CANCELLATIONTOKEN_H_ */
@@ -35,12 +35,30 @@
 
 using namespace opencog;
 
-MixtureModel::MixtureModel(const HandleSet& mds, double cpx, double cmp) :
-	models(mds), cpx_penalty(cpx), compressiveness(cmp)
+MixtureModel::MixtureModel(const HandleSet& mds, double cpx, double cmp,
+                           const ModelStatsMap* sts) :
+	models(mds), cpx_penalty(cpx), compressiveness(cmp), stats(sts)
 {
 	data_set_size = infer_data_set_size();
 }
 
+MixtureModel::ModelStats MixtureModel::model_stats(const Handle& model)
+{
+	TruthValuePtr tv = model->getTruthValue();
+	return {tv, model_length(model), tv_beta_factor(tv)};
+}
+
+double MixtureModel::model_length(const Handle& model)
+{
+	return get_all_uniq_atoms(model).size();
+}
+
+double MixtureModel::tv_beta_factor(const TruthValuePtr& tv)
+{
+	BetaDistribution beta_dist(tv);
+	return boost::math::beta(beta_dist.alpha(), beta_dist.beta());
+}
+
 TruthValuePtr MixtureModel::operator()() const
 {
 	// Don't bother mixing if there's only one TV
@@ -95,8 +113,9 @@ TruthValuePtr MixtureModel::weighted_average(const std::vector<TruthValuePtr>& t
 
 double MixtureModel::beta_factor(const Handle& model) const
 {
-	BetaDistribution beta_dist(model->getTruthValue());
-	double factor = boost::math::beta(beta_dist.alpha(), beta_dist.beta());
+	const ModelStats* ms = find_stats(model);
+	double factor = ms ? ms->beta_factor
+		: tv_beta_factor(model->getTruthValue());
 	LAZY_URE_LOG_FINE << "MixtureModel::beta_factor factor = " << factor;
 	return factor;
 }
@@ -105,8 +124,8 @@ double MixtureModel::prior_estimate(const Handle& model) const
 {
 	LAZY_URE_LOG_FINE << "MixtureModel::prior_estimate model = " << model->id_to_string();
 
-	HandleSet all_atoms(get_all_uniq_atoms(model));
-	double partial_length = all_atoms.size(),
+	const ModelStats* ms = find_stats(model);
+	double partial_length = ms ? ms->length : model_length(model),
 		remain_data_size = data_set_size - model->getTruthValue()->get_count(),
 		kestimate = kolmogorov_estimate(remain_data_size);
 
@@ -131,6 +150,16 @@ double MixtureModel::prior(double length) const
 	return pri;
 }
 
+const MixtureModel::ModelStats* MixtureModel::find_stats(const Handle& model) const
+{
+	if (not stats)
+		return nullptr;
+	auto it = stats->find(model);
+	if (it == stats->end() or it->second.tv != model->getTruthValue())
+		return nullptr;
+	return &it->second;
+}
+
 double MixtureModel::infer_data_set_size() const
 {
 	double max_count = 0.0;
@@ -23,6 +23,8 @@
 #ifndef _OPENCOG_MIXTUREMODEL_H_
 #define _OPENCOG_MIXTUREMODEL_H_
 
+#include <map>
+
 #include <opencog/atoms/base/Handle.h>
 #include <opencog/atoms/truthvalue/TruthValue.h>
 
@@ -39,6 +41,22 @@ namespace opencog
 class MixtureModel
 {
 public:
+	// Statistics of a model that do not depend on the other models of
+	// the mixture, thus can be calculated once per model, as long as
+	// its TV does not change.
+	struct ModelStats
+	{
+		// TV the statistics have been calculated from
+		TruthValuePtr tv;
+
+		// Number of unique atoms in the model
+		double length;
+
+		// Beta(alpha, beta) of the model TV
+		double beta_factor;
+	};
+	typedef std::map<Handle, ModelStats> ModelStatsMap;
+
 	// Set of active models. Active means that they fulfill the
 	// preconditions of the data to explain.
 	HandleSet models;
@@ -63,12 +81,34 @@ public:
 	// model might be.
 	double data_set_size;
 
+	// Precomputed statistics of the models, if any. Models missing
+	// from it have their statistics calculated on the fly.
+	const ModelStatsMap* stats;
+
 	/**
 	 * Ctor
 	 */
 	MixtureModel(const HandleSet& models,
 	             double cpx_penalty=1.0,
-	             double compressiveness=0.0);
+	             double compressiveness=0.0,
+	             const ModelStatsMap* stats=nullptr);
+
+	/**
+	 * Calculate the statistics of a model, see ModelStats.
+	 */
+	static ModelStats model_stats(const Handle& model);
+
+	/**
+	 * Return the length of a model, the number of unique atoms
+	 * involved in its definition.
+	 */
+	static double model_length(const Handle& model);
+
+	/**
+	 * Return Beta(alpha, beta) of the given TV, where Beta is the
+	 * beta function.
+	 */
+	static double tv_beta_factor(const TruthValuePtr& tv);
 
 	/**
 	 * Calculate the TV of the mixture model. Assuming the ith model,
@@ -160,6 +200,12 @@ public:
 	double prior(double length) const;
 
 private:
+	/**
+	 * Return the precomputed statistics of model, nullptr if none or
+	 * if outdated.
+	 */
+	const ModelStats* find_stats(const Handle& model) const;
+
 	/**
 	 * Infer the data set size by taking the max count of all models
 	 * (it works assuming that one of them is complete).
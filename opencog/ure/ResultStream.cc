@@ -0,0 +1,178 @@
+/*
+ * ResultStream.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <chrono>
+#include <sstream>
+
+#include <opencog/atoms/base/Atom.h>
+
+#include "ResultStream.h"
+
+namespace opencog {
+
+std::string ResultEvent::to_string(const std::string& indent) const
+{
+	std::stringstream ss;
+	ss << indent << "iteration: " << iteration << std::endl
+	   << indent << "rule:" << std::endl
+	   << (rule ? rule->to_short_string(indent + OC_TO_STRING_INDENT)
+	       : indent + OC_TO_STRING_INDENT + "none") << std::endl
+	   << indent << "origin:" << std::endl
+	   << oc_to_string(origin, indent + OC_TO_STRING_INDENT)
+	   << indent << "product:" << std::endl
+	   << oc_to_string(product, indent + OC_TO_STRING_INDENT);
+	return ss.str();
+}
+
+ResultStream::ResultStream()
+	: _queue_enabled(false), _closed(false), _size(0) {}
+
+void ResultStream::set_callback(const ResultCallback& cb)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_callback = cb;
+}
+
+void ResultStream::enable_queue(bool enabled)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_queue_enabled = enabled;
+	if (not _queue_enabled)
+		_queue.clear();
+}
+
+bool ResultStream::is_queue_enabled() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _queue_enabled;
+}
+
+void ResultStream::emit(unsigned iteration, const Handle& rule,
+                        const Handle& origin, const HandleSet& products)
+{
+	std::vector<ResultEvent> to_call;
+	bool notify = false;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (products.empty() or not is_listened())
+			return;
+		for (const Handle& product : products)
+			emit_product(iteration, rule, origin, product, to_call);
+		notify = _queue_enabled;
+	}
+	if (notify)
+		_cv.notify_all();
+	call(to_call);
+}
+
+void ResultStream::emit(unsigned iteration, const Handle& rule,
+                        const Handle& origin, const HandleSeq& products)
+{
+	emit(iteration, rule, origin, HandleSet(products.begin(), products.end()));
+}
+
+bool ResultStream::try_pop(ResultEvent& re)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_queue.empty())
+		return false;
+	re = _queue.front();
+	_queue.pop_front();
+	return true;
+}
+
+bool ResultStream::pop(ResultEvent& re, int timeout_ms)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto ready = [&]() { return not _queue.empty() or _closed; };
+	if (timeout_ms < 0)
+		_cv.wait(lock, ready);
+	else
+		_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+
+	if (_queue.empty())
+		return false;
+	re = _queue.front();
+	_queue.pop_front();
+	return true;
+}
+
+void ResultStream::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_closed = true;
+	}
+	_cv.notify_all();
+}
+
+bool ResultStream::is_closed() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _closed;
+}
+
+size_t ResultStream::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _size;
+}
+
+bool ResultStream::is_listened() const
+{
+	return _queue_enabled or (bool)_callback;
+}
+
+void ResultStream::emit_product(unsigned iteration, const Handle& rule,
+                                const Handle& origin, const Handle& product,
+                                std::vector<ResultEvent>& to_call)
+{
+	_size++;
+	ResultEvent re(iteration, rule, origin, product);
+	if (_callback)
+		to_call.push_back(re);
+	if (_queue_enabled)
+		_queue.push_back(re);
+}
+
+void ResultStream::call(const std::vector<ResultEvent>& events) const
+{
+	if (events.empty())
+		return;
+
+	// Copy the callback so that it can be called without holding the
+	// lock, the callback may very well be consuming the queue.
+	ResultCallback cb;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		cb = _callback;
+	}
+	if (cb)
+		for (const ResultEvent& re : events)
+			cb(re);
+}
+
+std::string oc_to_string(const ResultEvent& re, const std::string& indent)
+{
+	return re.to_string(indent);
+}
+
+} // namespace opencog
@@ -0,0 +1,162 @@
+/*
+ * ResultStream.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_RESULTSTREAM_H_
+#define _OPENCOG_RESULTSTREAM_H_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+#include <opencog/util/empty_string.h>
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog
+{
+
+/**
+ * A result as delivered by the stream, that is a product together
+ * with the iteration, the rule and the source (in the case of the
+ * forward chainer) or the FCS (in the case of the backward chainer)
+ * that produced it.
+ */
+struct ResultEvent
+{
+	ResultEvent() : iteration(0) {}
+	ResultEvent(unsigned i, const Handle& r, const Handle& o, const Handle& p)
+		: iteration(i), rule(r), origin(o), product(p) {}
+
+	// Iteration, starting at 1, during which the product was derived
+	unsigned iteration;
+
+	// Alias of the rule that produced it. Undefined in the case of
+	// the backward chainer as a whole FCS is being executed.
+	Handle rule;
+
+	// Source (FC) or FCS (BC) that produced it
+	Handle origin;
+
+	// The product itself
+	Handle product;
+
+	std::string to_string(const std::string& indent=empty_string) const;
+};
+
+typedef std::function<void(const ResultEvent&)> ResultCallback;
+
+/**
+ * Deliver the results of a chainer as soon as they are derived,
+ * rather than having to wait for do_chain() to return.
+ *
+ * Results can be consumed either by registering a callback, called
+ * from the chaining thread right after the product has been inserted
+ * in the knowledge base, or by enabling the queue and popping results
+ * from another thread. Both can be used at the same time.
+ *
+ * The stream does not keep track of the products it has delivered,
+ * it is up to the chainers to only emit products that are new to
+ * them, which they already know from their own result sets.
+ */
+class ResultStream
+{
+public:
+	ResultStream();
+
+	/**
+	 * Register a callback to be called on each new result. Passing an
+	 * empty callback disables it.
+	 */
+	void set_callback(const ResultCallback& cb);
+
+	/**
+	 * Enable or disable the result queue. It is disabled by default so
+	 * that results do not pile up when no consumer is listening.
+	 */
+	void enable_queue(bool enabled=true);
+	bool is_queue_enabled() const;
+
+	/**
+	 * Emit the products of a rule application (or FCS execution),
+	 * assumed to have not been emitted before.
+	 */
+	void emit(unsigned iteration, const Handle& rule, const Handle& origin,
+	          const HandleSet& products);
+	void emit(unsigned iteration, const Handle& rule, const Handle& origin,
+	          const HandleSeq& products);
+
+	/**
+	 * Pop the next result, if any, without blocking. Return true iff a
+	 * result has been popped.
+	 */
+	bool try_pop(ResultEvent& re);
+
+	/**
+	 * Pop the next result, blocking till one is available, the stream
+	 * is closed, or timeout_ms milliseconds have elapsed. A negative
+	 * timeout means wait for ever. Return true iff a result has been
+	 * popped.
+	 */
+	bool pop(ResultEvent& re, int timeout_ms=-1);
+
+	/**
+	 * Close the stream, waking up all consumers blocked on pop. This
+	 * is called by the chainers at the end of do_chain(). Results still
+	 * in the queue can be popped after closing.
+	 */
+	void close();
+	bool is_closed() const;
+
+	/**
+	 * Number of results emitted so far.
+	 */
+	size_t size() const;
+
+private:
+	// Return true if a consumer is listening
+	bool is_listened() const;
+
+	// Emit a single product, assume _mutex is locked
+	void emit_product(unsigned iteration, const Handle& rule,
+	                  const Handle& origin, const Handle& product,
+	                  std::vector<ResultEvent>& to_call);
+
+	// Call the callback, outside of the lock, on the given events
+	void call(const std::vector<ResultEvent>& events) const;
+
+	ResultCallback _callback;
+	bool _queue_enabled;
+	bool _closed;
+
+	// Number of products emitted so far
+	size_t _size;
+
+	std::deque<ResultEvent> _queue;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _cv;
+};
+
+std::string oc_to_string(const ResultEvent& re,
+                         const std::string& indent=empty_string);
+
+} // namespace opencog
+
+#endif /* _OPENCOG_RESULTSTREAM_H_ */
@@ -23,6 +23,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cmath>
 #include <queue>
 
 #include <boost/uuid/uuid_io.hpp>
@@ -38,6 +39,7 @@
 #include <opencog/atoms/core/Quotation.h>
 #include <opencog/atoms/core/TypeUtils.h>
 #include <opencog/atoms/pattern/BindLink.h>
+#include <opencog/atoms/truthvalue/SimpleTruthValue.h>
 
 #include <opencog/atomspace/AtomSpace.h>
 #include <opencog/unify/Unify.h>
@@ -136,6 +138,29 @@ TruthValueSeq RuleSet::get_tvs() const
 	return tvs;
 }
 
+TruthValuePtr RuleSet::update_tv(const Handle& alias,
+                                 double successes, double failures)
+{
+	TruthValuePtr tv;
+	for (const RulePtr& rule : *this) {
+		if (rule->get_alias() != alias)
+			continue;
+		if (not tv) {
+			rule->update_tv(successes, failures);
+			tv = rule->get_tv();
+		} else {
+			rule->set_tv(tv);
+		}
+	}
+	return tv;
+}
+
+void RuleSet::save_tvs() const
+{
+	for (const RulePtr& rule : *this)
+		rule->save_tv();
+}
+
 std::string RuleSet::to_string(const std::string& indent) const
 {
 	std::stringstream ss;
@@ -174,7 +199,7 @@ Rule::Rule(const Rule& r)
 	_rule_alias = r._rule_alias;
 	_name = r._name;
 	_rbs = r._rbs;
-	_tv = r._tv;
+	_tv = r.get_tv();
 	_exhausted = r._exhausted;
 }
 
@@ -265,7 +290,7 @@ Rule& Rule::operator=(const Rule& r)
 	_rule_alias = r._rule_alias;
 	_name = r._name;
 	_rbs = r._rbs;
-	_tv = r._tv;
+	set_tv(r.get_tv());
 	_exhausted = r._exhausted;
 
 	return *this;
@@ -273,7 +298,38 @@ Rule& Rule::operator=(const Rule& r)
 
 TruthValuePtr Rule::get_tv() const
 {
-	return _tv;
+	return std::atomic_load(&_tv);
+}
+
+void Rule::set_tv(const TruthValuePtr& tv)
+{
+	std::atomic_store(&_tv, tv);
+}
+
+void Rule::update_tv(double successes, double failures)
+{
+	TruthValuePtr tv = get_tv();
+	double prior_count = tv->get_count();
+	if (not std::isfinite(prior_count))
+		return;
+
+	double count = prior_count + successes + failures;
+	if (count <= 0)
+		return;
+	double pos_count = tv->get_mean() * prior_count + successes;
+	double confidence = count / (count + SimpleTruthValue::DEFAULT_K);
+	set_tv(SimpleTruthValue::createTV(pos_count / count, confidence));
+}
+
+void Rule::save_tv() const
+{
+	if (not _rule_alias or not _rbs or not _rule_alias->getAtomSpace())
+		return;
+
+	AtomSpace& as = *_rule_alias->getAtomSpace();
+	Handle ml = as.get_link(MEMBER_LINK, _rule_alias, _rbs);
+	if (ml)
+		ml->setTruthValue(get_tv());
 }
 
 void Rule::set_name(const std::string& name)
@@ -621,7 +677,7 @@ std::string Rule::to_string(const std::string& indent) const
 	std::stringstream ss;
 	ss << indent << "name: " << _name << std::endl
 	   << indent << "rbs: " << _rbs->to_short_string() << std::endl
-	   << indent << "tv: " << _tv->to_string() << std::endl
+	   << indent << "tv: " << get_tv()->to_string() << std::endl
 	   << indent << "exhausted: " << is_exhausted() << std::endl
 	   << indent << "rule:" << std::endl
 	   << _rule->to_string(indent + OC_TO_STRING_INDENT);
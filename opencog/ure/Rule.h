@@ -107,6 +107,22 @@ public:
 	 */
 	TruthValueSeq get_tvs() const;
 
+	/**
+	 * Update the TVs of all rules of the given alias, given the
+	 * number of successful and failed applications of that rule, see
+	 * Rule::update_tv. The TV of the first rule of that alias is used
+	 * as prior and the posterior is shared by all of them. Return the
+	 * posterior, or nullptr if no rule has that alias.
+	 */
+	TruthValuePtr update_tv(const Handle& alias,
+	                        double successes, double failures);
+
+	/**
+	 * Write the TVs of all rules back to their rule-based system, see
+	 * Rule::save_tv.
+	 */
+	void save_tvs() const;
+
 	std::string to_string(const std::string& indent=empty_string) const;
 	std::string to_short_string(const std::string& indent=empty_string) const;
 };
@@ -271,6 +287,24 @@ public:
 	 * Get the TruthValue associated with the rule.
 	 */
 	TruthValuePtr get_tv() const;
+	void set_tv(const TruthValuePtr& tv);
+
+	/**
+	 * Update the TV of the rule given the number of successful and
+	 * failed applications observed since. The TV is treated as a
+	 * beta posterior (see BetaDistribution), the successes and
+	 * failures are added to its positive and total counts.
+	 *
+	 * A TV of confidence 1 (thus infinite count) is left unchanged.
+	 */
+	void update_tv(double successes, double failures);
+
+	/**
+	 * Set the TV of the MemberLink connecting the rule alias to its
+	 * rule-based system, if it exists, to the TV of the rule, so that
+	 * subsequent chainers start from it.
+	 */
+	void save_tv() const;
 
 	/**
 	 * Used by the forward chainer to select rules. Given a source,
@@ -365,6 +399,9 @@ private:
 	// It is best to have this TV with a confidence lower than 1,
 	// otherwise, if given the choice between several valid rules, the
 	// URE will always choose the one with the highest confidence.
+	//
+	// It may be updated during chaining, see update_tv, thus is only
+	// accessed atomically.
 	TruthValuePtr _tv;
 
 	// True if the rule has already been applied.
@@ -0,0 +1,163 @@
+/*
+ * RuleBaseCache.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <boost/functional/hash.hpp>
+
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/atoms/truthvalue/TruthValue.h>
+
+#include "RuleBaseCache.h"
+
+namespace opencog {
+
+const size_t RuleBaseCache::capacity = 256;
+
+RuleBaseCache::RuleBaseCache() : _hits(0), _misses(0) {}
+
+RuleBaseCache& RuleBaseCache::instance()
+{
+	static RuleBaseCache cache;
+	return cache;
+}
+
+UREConfigPtr RuleBaseCache::get(AtomSpace& as, const Handle& rbs)
+{
+	if (Handle::UNDEFINED == rbs)
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseCache - invalid rulebase specified!");
+
+	Key key(&as, rbs.get());
+	size_t rbs_stamp = stamp(rbs);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _entries.find(key);
+		if (it != _entries.end() and it->second.stamp == rbs_stamp) {
+			_lru.splice(_lru.begin(), _lru, it->second.lru);
+			_hits++;
+			return it->second.config;
+		}
+		_misses++;
+	}
+
+	// Build the snapshot without holding the lock, as it is
+	// expensive. Concurrent misses on the same rule base may thus
+	// build it more than once.
+	UREConfigPtr config = std::make_shared<const UREConfig>(as, rbs);
+	insert(as, rbs, rbs_stamp, config);
+	return config;
+}
+
+Handle RuleBaseCache::load(AtomSpace& as, const std::string& filename)
+{
+	UREConfigPtr config = std::make_shared<const UREConfig>(as, filename);
+	const Handle& rbs = config->get_rbs();
+	insert(as, rbs, stamp(rbs), config);
+	return rbs;
+}
+
+void RuleBaseCache::insert(AtomSpace& as, const Handle& rbs,
+                           size_t rbs_stamp, const UREConfigPtr& config)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	Key key(&as, rbs.get());
+	auto it = _entries.find(key);
+	if (it != _entries.end()) {
+		_lru.erase(it->second.lru);
+		_entries.erase(it);
+	}
+	if (capacity <= _entries.size())
+		evict();
+	_lru.push_front(key);
+	_entries[key] = {rbs, rbs_stamp, config, _lru.begin()};
+}
+
+void RuleBaseCache::evict()
+{
+	// Drop the snapshots of rule bases that are no longer in their
+	// atomspace, because it has been cleared or destroyed
+	size_t size = _entries.size();
+	for (auto it = _entries.begin(); it != _entries.end();) {
+		if (it->second.rbs->getAtomSpace() == nullptr) {
+			_lru.erase(it->second.lru);
+			it = _entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// Otherwise drop the least recently used one
+	if (size == _entries.size() and not _lru.empty()) {
+		_entries.erase(_lru.back());
+		_lru.pop_back();
+	}
+}
+
+size_t RuleBaseCache::stamp(const Handle& rbs)
+{
+	// The incoming set is not ordered, thus link hashes are summed
+	size_t seed = 0;
+	for (const Handle& link : rbs->getIncomingSet()) {
+		size_t link_seed = link->get_hash();
+		TruthValuePtr tv = link->getTruthValue();
+		boost::hash_combine(link_seed, tv->get_mean());
+		boost::hash_combine(link_seed, tv->get_confidence());
+
+		// Take into account rule definitions, as a rule may be
+		// redefined while keeping its alias
+		if (link->get_type() == MEMBER_LINK)
+			for (const Handle& def :
+				     link->getOutgoingAtom(0)->getIncomingSetByType(DEFINE_LINK))
+				boost::hash_combine(link_seed, def->get_hash());
+
+		seed += link_seed;
+	}
+	boost::hash_combine(seed, rbs->getIncomingSetSize());
+	return seed;
+}
+
+void RuleBaseCache::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries.clear();
+	_lru.clear();
+	_hits = 0;
+	_misses = 0;
+}
+
+size_t RuleBaseCache::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.size();
+}
+
+unsigned long RuleBaseCache::hits() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _hits;
+}
+
+unsigned long RuleBaseCache::misses() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _misses;
+}
+
+} // namespace opencog
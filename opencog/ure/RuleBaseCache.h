@@ -0,0 +1,132 @@
+/*
+ * RuleBaseCache.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_RULEBASECACHE_H_
+#define _OPENCOG_RULEBASECACHE_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "UREConfig.h"
+
+namespace opencog
+{
+
+typedef std::shared_ptr<const UREConfig> UREConfigPtr;
+
+/**
+ * Process-wide cache of rule-base configurations, so that chainers
+ * repeatedly built over the same rule base do not fetch its rules
+ * and parameters from the atomspace over and over again, which
+ * involves many pattern matcher queries.
+ *
+ * Configurations are immutable snapshots, keyed by atomspace and
+ * rule-based system, and stamped with the state of the rule base
+ * when taken, see stamp. A snapshot whose stamp no longer matches is
+ * rebuilt. The rule-based system is keyed by identity rather than
+ * content, so that a rule base whose atomspace has been cleared or
+ * destroyed, then recreated, possibly at the same address, does not
+ * get the snapshot of the former one, which refers to atoms and an
+ * atomspace that are gone. When full, the cache drops such stale
+ * snapshots, or else the least recently used one.
+ *
+ * Chainers work on their own copy of the snapshot, see
+ * UREConfig copy constructor, so that modifying their configuration
+ * or rules does not affect the snapshot.
+ *
+ * It is thread safe.
+ */
+class RuleBaseCache
+{
+public:
+	/**
+	 * Return the cache shared by the whole process.
+	 */
+	static RuleBaseCache& instance();
+
+	/**
+	 * Return the configuration of rbs in as, reusing its snapshot if
+	 * the rule base has not changed since it was taken.
+	 */
+	UREConfigPtr get(AtomSpace& as, const Handle& rbs);
+
+	/**
+	 * Load a rule base in as from a file written by UREConfig::save,
+	 * and keep its configuration as snapshot, so that constructing
+	 * the first chainer over it does not query the atomspace. Return
+	 * the rule-based system.
+	 */
+	Handle load(AtomSpace& as, const std::string& filename);
+
+	/**
+	 * Return a stamp of the state of the rule base, that is a hash of
+	 * all links involving rbs (its rule memberships and parameters)
+	 * with their TVs, as well as the definitions of its rules. It
+	 * only costs a traversal of the incoming set of rbs.
+	 */
+	static size_t stamp(const Handle& rbs);
+
+	// Maximum number of snapshots
+	static const size_t capacity;
+
+	void clear();
+
+	size_t size() const;
+	unsigned long hits() const;
+	unsigned long misses() const;
+
+private:
+	RuleBaseCache();
+
+	// The rule-based system atom is held by its entry, thus its
+	// address cannot be reused while the entry exists.
+	typedef std::pair<const AtomSpace*, const Atom*> Key;
+	struct Entry
+	{
+		Handle rbs;
+		size_t stamp;
+		UREConfigPtr config;
+		std::list<Key>::iterator lru;
+	};
+	std::map<Key, Entry> _entries;
+
+	// Keys from the most to the least recently used
+	std::list<Key> _lru;
+
+	// Insert the snapshot of the configuration of rbs in as
+	void insert(AtomSpace& as, const Handle& rbs, size_t rbs_stamp,
+	            const UREConfigPtr& config);
+
+	// Make room for a new snapshot, assume _mutex is locked
+	void evict();
+
+	unsigned long _hits;
+	unsigned long _misses;
+
+	mutable std::mutex _mutex;
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_RULEBASECACHE_H_ */
@@ -0,0 +1,247 @@
+/*
+ * RuleBaseFile.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/atoms/base/Node.h>
+
+#include "RuleBaseFile.h"
+
+namespace opencog {
+
+// Magic strings starting the files, including the format version
+const std::string rule_base_magic = "URERB004";
+const std::string fc_checkpoint_magic = "UREFC003";
+const std::string bit_snapshot_magic = "UREBT004";
+
+// Byte order mark, written right after the magic string
+static const uint32_t byte_order_mark = 0x01020304;
+
+template<typename T>
+static void append(std::string& buffer, const T& value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void append_string(std::string& buffer, const std::string& str)
+{
+	append(buffer, (uint32_t)str.size());
+	buffer.append(str);
+}
+
+RuleBaseWriter::RuleBaseWriter(const std::string& magic) : _magic(magic) {}
+
+uint32_t RuleBaseWriter::index(const Handle& h)
+{
+	auto it = _indices.find(h);
+	if (it != _indices.end())
+		return it->second;
+
+	std::string record;
+	append_string(record, nameserver().getTypeName(h->get_type()));
+	if (h->is_node()) {
+		append(record, (uint8_t)0);
+		append_string(record, h->get_name());
+	} else {
+		append(record, (uint8_t)1);
+		append(record, (uint32_t)h->get_arity());
+		for (const Handle& out : h->getOutgoingSet())
+			append(record, index(out));
+	}
+
+	// Outgoing atoms have been appended first
+	_atoms.append(record);
+	uint32_t idx = _indices.size();
+	_indices.emplace(h, idx);
+	return idx;
+}
+
+void RuleBaseWriter::put_atom(const Handle& h)
+{
+	append(_payload, index(h));
+}
+
+void RuleBaseWriter::put_tv(const TruthValuePtr& tv)
+{
+	append_string(_payload, nameserver().getTypeName(tv->get_type()));
+	const std::vector<double>& values = tv->value();
+	put_uint(values.size());
+	for (double d : values)
+		put_double(d);
+}
+
+void RuleBaseWriter::put_uint(uint32_t u)
+{
+	append(_payload, u);
+}
+
+void RuleBaseWriter::put_double(double d)
+{
+	append(_payload, d);
+}
+
+void RuleBaseWriter::put_bool(bool b)
+{
+	append(_payload, (uint8_t)b);
+}
+
+void RuleBaseWriter::write(const std::string& filename) const
+{
+	std::string header(_magic);
+	append(header, byte_order_mark);
+	append(header, (uint32_t)_indices.size());
+	append(header, (uint64_t)_atoms.size());
+
+	std::string payload_size;
+	append(payload_size, (uint64_t)_payload.size());
+
+	std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+	out.write(header.data(), header.size());
+	out.write(_atoms.data(), _atoms.size());
+	out.write(payload_size.data(), payload_size.size());
+	out.write(_payload.data(), _payload.size());
+	if (not out)
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseWriter - cannot write %s", filename.c_str());
+}
+
+RuleBaseReader::RuleBaseReader(AtomSpace& as, const std::string& filename,
+                               const std::string& magic)
+	: _pos(0), _filename(filename)
+{
+	std::ifstream in(filename, std::ios::binary);
+	if (not in)
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseReader - cannot read %s", filename.c_str());
+	_payload.assign(std::istreambuf_iterator<char>(in),
+	                std::istreambuf_iterator<char>());
+
+	// The whole file is first read as payload, then the header and
+	// atom table are stripped from it
+	if (std::string(read(magic.size()), magic.size()) != magic)
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseReader - %s does not start with %s",
+			filename.c_str(), magic.c_str());
+	if (get_uint() != byte_order_mark)
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseReader - %s has been written with another byte order",
+			filename.c_str());
+
+	uint32_t atom_count = get_uint();
+	read(sizeof(uint64_t));     // Size of the atom table
+	_atoms.reserve(atom_count);
+	for (uint32_t i = 0; i < atom_count; i++) {
+		uint32_t type_size = get_uint();
+		std::string type_name(read(type_size), type_size);
+		Type type = nameserver().getType(type_name);
+		if (type == NOTYPE)
+			throw RuntimeException(TRACE_INFO,
+				"RuleBaseReader - unknown type %s in %s",
+				type_name.c_str(), filename.c_str());
+
+		bool is_node = *read(1) == 0;
+		if (is_node) {
+			uint32_t name_size = get_uint();
+			std::string name(read(name_size), name_size);
+			_atoms.push_back(as.add_node(type, std::move(name)));
+		} else {
+			uint32_t arity = get_uint();
+			HandleSeq outgoing;
+			for (uint32_t j = 0; j < arity; j++)
+				outgoing.push_back(get_atom());
+			_atoms.push_back(as.add_link(type, std::move(outgoing)));
+		}
+	}
+
+	uint64_t payload_size;
+	std::memcpy(&payload_size, read(sizeof(uint64_t)), sizeof(uint64_t));
+	_payload.erase(0, _pos);
+	_pos = 0;
+	if (_payload.size() != payload_size)
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseReader - %s is truncated", filename.c_str());
+}
+
+const char* RuleBaseReader::read(size_t n)
+{
+	if (_payload.size() < _pos + n)
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseReader - unexpected end of %s", _filename.c_str());
+	const char* data = _payload.data() + _pos;
+	_pos += n;
+	return data;
+}
+
+Handle RuleBaseReader::get_atom()
+{
+	uint32_t idx = get_uint();
+	if (_atoms.size() <= idx)
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseReader - invalid atom index in %s", _filename.c_str());
+	return _atoms[idx];
+}
+
+Handle RuleBaseReader::get_atom(AtomSpace& as)
+{
+	return as.add_atom(get_atom());
+}
+
+TruthValuePtr RuleBaseReader::get_tv()
+{
+	uint32_t type_size = get_uint();
+	std::string type_name(read(type_size), type_size);
+	Type type = nameserver().getType(type_name);
+	if (not nameserver().isA(type, TRUTH_VALUE))
+		throw RuntimeException(TRACE_INFO,
+			"RuleBaseReader - unknown truth value type %s in %s",
+			type_name.c_str(), _filename.c_str());
+
+	uint32_t size = get_uint();
+	std::vector<double> values(size);
+	for (double& d : values)
+		d = get_double();
+	return TruthValue::factory(type, values);
+}
+
+uint32_t RuleBaseReader::get_uint()
+{
+	uint32_t u;
+	std::memcpy(&u, read(sizeof(u)), sizeof(u));
+	return u;
+}
+
+double RuleBaseReader::get_double()
+{
+	double d;
+	std::memcpy(&d, read(sizeof(d)), sizeof(d));
+	return d;
+}
+
+bool RuleBaseReader::get_bool()
+{
+	return *read(1) != 0;
+}
+
+} // namespace opencog
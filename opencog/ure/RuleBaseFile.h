@@ -0,0 +1,138 @@
+/*
+ * RuleBaseFile.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_RULEBASEFILE_H_
+#define _OPENCOG_RULEBASEFILE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <opencog/atomspace/AtomSpace.h>
+#include <opencog/atoms/truthvalue/TruthValue.h>
+
+namespace opencog
+{
+
+// Magic strings of rule base files, forward chainer checkpoints and
+// BIT snapshots
+extern const std::string rule_base_magic;
+extern const std::string fc_checkpoint_magic;
+extern const std::string bit_snapshot_magic;
+
+/**
+ * Binary encoding of a rule base, see UREConfig::save and the
+ * UREConfig constructor taking a file name. The same encoding is used
+ * for forward chainer checkpoints and BIT snapshots, with different
+ * magic strings, see ForwardChainer::save_checkpoint and
+ * BackwardChainer::save_snapshot.
+ *
+ * A file is made of
+ *
+ * 1. a header: a magic string, "URERB004" for rule bases, including
+ *    the format version, a byte order mark, then
+ *    the number of atoms and the size in bytes of the atom table;
+ * 2. the atom table: each atom is given by its type name, then
+ *    either its name if it is a node, or its arity followed by the
+ *    indices of its outgoing atoms if it is a link. Outgoing atoms
+ *    always come before the links they belong to, so that the table
+ *    can be loaded into an atomspace in a single pass;
+ * 3. the payload: its size in bytes, followed by the content written
+ *    by the user of the file, where atoms are referred to by their
+ *    indices in the table, and TVs by their type name followed by
+ *    their values, so that TVs of any type are kept.
+ *
+ * Integers and doubles are stored in the byte order of the machine
+ * that has written them, which is checked at loading.
+ */
+class RuleBaseWriter
+{
+public:
+	RuleBaseWriter(const std::string& magic=rule_base_magic);
+
+	/**
+	 * Append to the payload.
+	 */
+	void put_atom(const Handle& h);
+	void put_tv(const TruthValuePtr& tv);
+	void put_uint(uint32_t u);
+	void put_double(double d);
+	void put_bool(bool b);
+
+	/**
+	 * Write the file, throw a RuntimeException if it cannot be
+	 * written.
+	 */
+	void write(const std::string& filename) const;
+
+private:
+	// Return the index of h in the atom table, inserting it, as well
+	// as its outgoing atoms, if not already.
+	uint32_t index(const Handle& h);
+
+	const std::string _magic;
+
+	std::map<Handle, uint32_t> _indices;
+	std::string _atoms;
+	std::string _payload;
+};
+
+class RuleBaseReader
+{
+public:
+	/**
+	 * Read the file and load its atom table into as. Throw a
+	 * RuntimeException if it cannot be read, does not start with
+	 * magic, or is ill-formed.
+	 */
+	RuleBaseReader(AtomSpace& as, const std::string& filename,
+	               const std::string& magic=rule_base_magic);
+
+	/**
+	 * Read from the payload, in the order it has been written. Throw
+	 * a RuntimeException past its end.
+	 */
+	Handle get_atom();
+	TruthValuePtr get_tv();
+	uint32_t get_uint();
+	double get_double();
+	bool get_bool();
+
+	/**
+	 * Like get_atom, but return its copy in as, for atoms that belong
+	 * to another atomspace than the one the table has been loaded
+	 * into.
+	 */
+	Handle get_atom(AtomSpace& as);
+
+private:
+	HandleSeq _atoms;
+	std::string _payload;
+	size_t _pos;
+
+	const std::string _filename;
+
+	// Read n bytes from the payload
+	const char* read(size_t n);
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_RULEBASEFILE_H_ */
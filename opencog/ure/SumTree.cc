@@ -0,0 +1,109 @@
+/*
+ * SumTree.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include <opencog/util/oc_assert.h>
+
+#include "SumTree.h"
+
+namespace opencog {
+
+SumTree::SumTree() : _capacity(1), _nodes(2, 0.0) {}
+
+void SumTree::set(size_t i, double weight)
+{
+	OC_ASSERT(0 <= weight, "Weights of a SumTree must be non-negative");
+	reserve(i + 1);
+
+	// Set the leaf and recalculate its ancestors from their children,
+	// rather than adding the difference, to not accumulate rounding
+	// errors.
+	size_t k = _capacity + i;
+	_nodes[k] = weight;
+	for (k /= 2; 0 < k; k /= 2)
+		_nodes[k] = _nodes[2*k] + _nodes[2*k + 1];
+}
+
+double SumTree::get(size_t i) const
+{
+	return i < _capacity ? _nodes[_capacity + i] : 0.0;
+}
+
+double SumTree::total() const
+{
+	return _nodes[1];
+}
+
+size_t SumTree::capacity() const
+{
+	return _capacity;
+}
+
+void SumTree::clear()
+{
+	std::fill(_nodes.begin(), _nodes.end(), 0.0);
+}
+
+size_t SumTree::find(double u) const
+{
+	size_t k = 1;
+	while (k < _capacity) {
+		double left = _nodes[2*k];
+		// Go right if u is beyond the left sum, unless the right
+		// subtree is empty, which may happen due to rounding errors
+		if (left <= u and 0 < _nodes[2*k + 1]) {
+			u -= left;
+			k = 2*k + 1;
+		} else {
+			k = 2*k;
+		}
+	}
+	return k - _capacity;
+}
+
+size_t SumTree::sample(RandGen& rng) const
+{
+	OC_ASSERT(0 < total(), "Cannot sample from a SumTree of null weight");
+	return find(rng.randdouble() * total());
+}
+
+void SumTree::reserve(size_t n)
+{
+	if (n <= _capacity)
+		return;
+
+	// Double the capacity till it is enough, then rebuild the
+	// internal nodes from the leaves.
+	size_t capacity = _capacity;
+	while (capacity < n)
+		capacity *= 2;
+	std::vector<double> nodes(2 * capacity, 0.0);
+	std::copy(_nodes.begin() + _capacity, _nodes.end(),
+	          nodes.begin() + capacity);
+	for (size_t k = capacity - 1; 0 < k; k--)
+		nodes[k] = nodes[2*k] + nodes[2*k + 1];
+
+	_capacity = capacity;
+	_nodes.swap(nodes);
+}
+
+} // namespace opencog
@@ -0,0 +1,104 @@
+/*
+ * SumTree.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_SUMTREE_H_
+#define _OPENCOG_SUMTREE_H_
+
+#include <vector>
+
+#include <opencog/util/mt19937ar.h>
+
+namespace opencog
+{
+
+/**
+ * Weighted index over elements identified by integers, allowing to
+ * update the weight of an element, and to sample an element with
+ * probability proportional to its weight, both in O(log n).
+ *
+ * It is a binary tree stored in an array, where each leaf holds the
+ * weight of an element and each internal node holds the sum of the
+ * weights of its children. Sampling goes down from the root, going
+ * left or right according to the children sums.
+ *
+ * This allows to avoid rebuilding a std::discrete_distribution over
+ * the entire population when only a few weights change between
+ * samplings.
+ */
+class SumTree
+{
+public:
+	SumTree();
+
+	/**
+	 * Set the weight of element i, growing the tree if necessary.
+	 * Weights must be non-negative.
+	 */
+	void set(size_t i, double weight);
+
+	/**
+	 * Return the weight of element i, 0 if it has never been set.
+	 */
+	double get(size_t i) const;
+
+	/**
+	 * Return the sum of all weights.
+	 */
+	double total() const;
+
+	/**
+	 * Return the number of elements the tree can hold without
+	 * growing.
+	 */
+	size_t capacity() const;
+
+	/**
+	 * Reset all weights to 0.
+	 */
+	void clear();
+
+	/**
+	 * Return the element such that the sum of the weights of the
+	 * elements before it is below or equal to u, and the sum
+	 * including its weight is above u. u must be in [0, total()).
+	 */
+	size_t find(double u) const;
+
+	/**
+	 * Sample an element with probability proportional to its
+	 * weight. The total weight must be positive.
+	 */
+	size_t sample(RandGen& rng=randGen()) const;
+
+private:
+	// Grow the tree so that it can hold at least n elements
+	void reserve(size_t n);
+
+	// Number of leaves, a power of 2
+	size_t _capacity;
+
+	// Nodes, the root is at index 1, the children of node k are at
+	// 2k and 2k+1, and the leaf of element i is at _capacity + i.
+	std::vector<double> _nodes;
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_SUMTREE_H_ */
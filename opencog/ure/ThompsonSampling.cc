@@ -23,7 +23,8 @@
 
 #include "ThompsonSampling.h"
 
-#include <boost/range/algorithm/transform.hpp>
+#include <cmath>
+
 #include <boost/range/algorithm/max_element.hpp>
 
 #include <opencog/util/Logger.h>
@@ -39,18 +40,33 @@ ThompsonSampling::ThompsonSampling(const TruthValueSeq& tvs, unsigned bins)
 
 std::vector<double> ThompsonSampling::distribution() const
 {
-	std::vector<double> probs(_tvs.size());
-
-	// Calculate cdfs for all TVs
-	std::vector<std::vector<double>> cdfs;
-	for (const auto& tv : _tvs)
-		cdfs.push_back(BetaDistribution(tv).cdf(_bins));
+	size_t n = _tvs.size();
+	std::vector<double> probs(n);
+
+	// Calculate cdfs, and their logs, for all TVs, stored
+	// contiguously, one row of bins per TV. Null cdfs have their log
+	// set to 0 and are counted apart.
+	std::vector<double> cdfs(n * _bins), log_cdfs(n * _bins);
+	std::vector<double> log_prod(_bins, 0.0);
+	std::vector<unsigned> zeros(_bins, 0);
+	for (size_t i = 0; i < n; i++) {
+		std::vector<double> cdf = BetaDistribution(_tvs[i]).cdf(_bins);
+		double* row = &cdfs[i * _bins];
+		double* log_row = &log_cdfs[i * _bins];
+		std::copy(cdf.begin(), cdf.end(), row);
+		for (size_t x = 0; x < _bins; x++) {
+			bool zero = row[x] <= 0.0;
+			log_row[x] = zero ? 0.0 : std::log(row[x]);
+			log_prod[x] += log_row[x];
+			zeros[x] += zero;
+		}
+	}
 
 	// Calculate Pi for all actions
 	// where Pi = I_0^1 pdfi(x) Prod_j!=i cdfj(x) dx
 	double nt = 0.0;            // normalizing term
-	for (size_t i = 0; i < _tvs.size(); i++) {
-		probs[i] = Pi(i, cdfs);
+	for (size_t i = 0; i < n; i++) {
+		probs[i] = Pi(&cdfs[i * _bins], &log_cdfs[i * _bins], log_prod, zeros);
 		nt += probs[i];
 	}
 
@@ -71,9 +87,13 @@ size_t ThompsonSampling::operator()(RandGen& rng) const
 		return 0;
 
 	// Randomly select a first order probability for each tv
-	std::vector<double> fops(_tvs.size());
-	boost::transform(_tvs, fops.begin(), [&](const auto& tv) {
-		return BetaDistribution(tv)(rng); });
+	std::vector<BetaDistribution::Parameters> params;
+	for (const auto& tv : _tvs) {
+		BetaDistribution bd(tv);
+		params.emplace_back(bd.alpha(), bd.beta());
+	}
+	std::vector<double> fops;
+	BetaDistribution::sample(params, fops, rng);
 
 	// Pick up one of the maxima
 	auto it = boost::max_element(fops);
@@ -85,28 +105,24 @@ size_t ThompsonSampling::operator()(RandGen& rng) const
 	return *std::next(maxima.begin(), rng.randint(maxima.size()));
 }
 
-double ThompsonSampling::Pi(size_t i,
-                            const std::vector<std::vector<double>>& cdfs) const
+double ThompsonSampling::Pi(const double* cdf, const double* log_cdf,
+                            const std::vector<double>& log_prod,
+                            const std::vector<unsigned>& zeros) const
 {
 	double result = 0.0;
-	size_t bins = cdfs[i].size();
 	// Perform right-end point Riemann sum of fi(x)
-	for (size_t x_idx = 0; x_idx < bins; x_idx++) {
+	for (size_t x_idx = 0; x_idx < _bins; x_idx++) {
 		// Calculate pdfi(x)*dx, that is the probability of the first
 		// order probability being within [(x_idx-1)/bins, x_idx/bins]
 		// using the derivative of the cdf
-		double f_x = cdfs[i][x_idx] - (x_idx == 0 ? 0.0 : cdfs[i][x_idx - 1]);
-
-		// Only bother calculating Prod_j!=i cdfj(x) if pdfi(x)*dx is
-		// greater than zero
-		if (f_x <= 0.0)
-			continue;
-
-		// Calculate Prod_j!=i cdfj(x)
-		for (size_t j = 0; j < _tvs.size(); j++)
-			if (j != i)
-				f_x *= cdfs[j][x_idx];
-		result += f_x;
+		double f_x = cdf[x_idx] - (x_idx == 0 ? 0.0 : cdf[x_idx - 1]);
+
+		// pdfi(x)*dx > 0 implies cdfi(x) > 0, so Prod_j!=i cdfj(x) is
+		// null iff any cdf is null at x, otherwise it is Prod_j
+		// cdfj(x) / cdfi(x). The loop is kept branch free so that it
+		// can be vectorized.
+		double prod = std::exp(log_prod[x_idx] - log_cdf[x_idx]);
+		result += (0.0 < f_x and zeros[x_idx] == 0) ? f_x * prod : 0.0;
 	}
 	return result;
 }
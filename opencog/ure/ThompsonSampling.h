@@ -67,6 +67,10 @@ public:
 	 *
 	 * See Section Inference Rule Selection in the README.md of the
 	 * pln inference-control-learning for more explanations.
+	 *
+	 * Prod_j cdfj(x) is calculated once per bin, in log space, so
+	 * that each Pi is derived from it by removing the contribution of
+	 * cdfi(x), making it O(n*bins) rather than O(n^2*bins).
 	 */
 	std::vector<double> distribution() const;
 
@@ -84,11 +88,15 @@ public:
 
 private:
 	/**
-	 * Helper for distribution(). Given a vector of cdf vector, one
-	 * cdf vector per action, calculate the unnormalized Pi (see the
-	 * comment of distribution()) for action i.
+	 * Helper for distribution(). Given the cdf of action i, the log
+	 * of its cdf (0 where the cdf is null), and for each bin, the sum
+	 * of the logs of all non-null cdfs and the number of null cdfs,
+	 * calculate the unnormalized Pi (see the comment of
+	 * distribution()) for action i.
 	 */
-	double Pi(size_t i, const std::vector<std::vector<double>>& cdfs) const;
+	double Pi(const double* cdf, const double* log_cdf,
+	          const std::vector<double>& log_prod,
+	          const std::vector<unsigned>& zeros) const;
 
 	// Sequence of TruthValues denoting the probability that the
 	// corresponding index is associated with fulfilling the objective
@@ -0,0 +1,174 @@
+/*
+ * TraceWriter.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <limits>
+
+#include "TraceWriter.h"
+#include "URELogger.h"
+
+using namespace opencog;
+
+TraceWriter::TraceWriter(AtomSpace* trace_as)
+	: _trace_as(trace_as), _sampling(1.0), _async(true),
+	  _writing(0), _stop(false),
+	  // Only draw from randGen() if tracing, so that untraced
+	  // chainers do not consume it
+	  _rng(trace_as ? randGen().randint(std::numeric_limits<int>::max()) : 0),
+	  _salt(_rng.randint(std::numeric_limits<int>::max())) {}
+
+TraceWriter::~TraceWriter()
+{
+	stop();
+}
+
+bool TraceWriter::enabled() const
+{
+	return _trace_as != nullptr;
+}
+
+bool TraceWriter::sample()
+{
+	if (not _trace_as)
+		return false;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (1.0 <= _sampling)
+		return true;
+	if (_sampling <= 0.0)
+		return false;
+	return _rng.randdouble() < _sampling;
+}
+
+bool TraceWriter::sample(const Handle& h) const
+{
+	if (not _trace_as)
+		return false;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (1.0 <= _sampling)
+		return true;
+	if (_sampling <= 0.0)
+		return false;
+
+	// Map the salted content hash to [0, 1) with the splitmix64
+	// finalizer, so that nearby hashes are not correlated
+	uint64_t x = h->get_hash() ^ _salt;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return (x >> 11) * (1.0 / (1ULL << 53)) < _sampling;
+}
+
+void TraceWriter::push(TraceEvent&& event)
+{
+	if (not _trace_as)
+		return;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (not _async) {
+		lock.unlock();
+		event(*_trace_as);
+		return;
+	}
+
+	// Start the writer lazily, only traced chainers pay for it
+	if (not _writer.joinable()) {
+		_stop = false;
+		_writer = std::thread(&TraceWriter::run, this);
+	}
+	_pending.push_back(std::move(event));
+	lock.unlock();
+	_pending_cv.notify_one();
+}
+
+void TraceWriter::flush()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_flushed_cv.wait(lock, [&]() { return _pending.empty() and _writing == 0; });
+}
+
+void TraceWriter::set_sampling(double sampling)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_sampling = sampling;
+}
+
+double TraceWriter::get_sampling() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _sampling;
+}
+
+void TraceWriter::set_async(bool async)
+{
+	if (not async)
+		stop();
+	std::lock_guard<std::mutex> lock(_mutex);
+	_async = async;
+}
+
+bool TraceWriter::is_async() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _async;
+}
+
+void TraceWriter::run()
+{
+	std::vector<TraceEvent> batch;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_pending_cv.wait(lock, [&]() { return not _pending.empty() or _stop; });
+		if (_pending.empty() and _stop)
+			break;
+
+		// Take the whole pending buffer and write it without holding
+		// the lock, so that the chainer is never blocked by the
+		// trace atomspace.
+		batch.swap(_pending);
+		_writing = batch.size();
+		lock.unlock();
+		for (TraceEvent& event : batch) {
+			try {
+				event(*_trace_as);
+			} catch (const std::exception& e) {
+				ure_logger().warn() << "Failed to write trace event: "
+				                    << e.what();
+			}
+		}
+		batch.clear();
+		lock.lock();
+		_writing = 0;
+		_flushed_cv.notify_all();
+	}
+}
+
+void TraceWriter::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (not _writer.joinable())
+			return;
+		_stop = true;
+	}
+	_pending_cv.notify_one();
+	_writer.join();
+}
@@ -0,0 +1,140 @@
+/*
+ * TraceWriter.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_TRACEWRITER_H_
+#define _OPENCOG_TRACEWRITER_H_
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+#include <opencog/util/mt19937ar.h>
+#include <opencog/atomspace/AtomSpace.h>
+
+namespace opencog
+{
+
+/**
+ * Write inference traces to the trace atomspace in the background,
+ * so that tracing does not slow down chaining.
+ *
+ * Trace events are closures inserting atoms in the trace atomspace.
+ * They are pushed by the chainer into a pending buffer, which a
+ * writer thread swaps for an empty one and inserts in batch. Pushing
+ * thus only takes a short uncontended lock.
+ *
+ * Optionally only a fraction of the events is recorded (sampling),
+ * either event by event, or atom by atom so that all the events
+ * related to the same atom (such as an and-BIT) are recorded or
+ * dropped together.
+ *
+ * If asynchronous writing is disabled events are written right
+ * away, as before.
+ */
+class TraceWriter
+{
+public:
+	typedef std::function<void(AtomSpace&)> TraceEvent;
+
+	TraceWriter(AtomSpace* trace_as);
+	~TraceWriter();
+
+	/**
+	 * Return true iff there is a trace atomspace to write to.
+	 */
+	bool enabled() const;
+
+	/**
+	 * Randomly decide whether the next event should be recorded,
+	 * according to the sampling fraction. Should be called before
+	 * building the event, to avoid building events that are
+	 * dropped anyway.
+	 */
+	bool sample();
+
+	/**
+	 * Like sample() but decide for a given atom, always giving the
+	 * same answer for the same atom content, so that all events
+	 * about that atom are kept or dropped together.
+	 */
+	bool sample(const Handle& h) const;
+
+	/**
+	 * Push an event to be written. Do nothing if not enabled.
+	 */
+	void push(TraceEvent&& event);
+
+	/**
+	 * Block till all pushed events have been written.
+	 */
+	void flush();
+
+	/**
+	 * Fraction of events to record, within [0, 1].
+	 */
+	void set_sampling(double sampling);
+	double get_sampling() const;
+
+	/**
+	 * Enable or disable writing in the background. Disabling flushes
+	 * pending events.
+	 */
+	void set_async(bool async);
+	bool is_async() const;
+
+private:
+	// Writer thread loop
+	void run();
+
+	// Stop and join the writer thread, if running, after having
+	// written all pending events.
+	void stop();
+
+	AtomSpace* _trace_as;
+	double _sampling;
+	bool _async;
+
+	// Events waiting to be written
+	std::vector<TraceEvent> _pending;
+
+	// Number of events taken by the writer but not yet written
+	size_t _writing;
+
+	bool _stop;
+	std::thread _writer;
+
+	// Random generator of the sampling, seeded from randGen() so that
+	// traces are reproducible, see sample
+	MT19937RandGen _rng;
+
+	// Salt of the atom content hashes, drawn from _rng, so that the
+	// sampled atoms vary with the seed, see sample(const Handle&)
+	uint64_t _salt;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _pending_cv;
+	std::condition_variable _flushed_cv;
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_TRACEWRITER_H_ */
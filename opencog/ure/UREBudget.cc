@@ -0,0 +1,125 @@
+/*
+ * UREBudget.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <fstream>
+#include <unistd.h>
+
+#include <opencog/util/platform.h>
+
+#include "UREBudget.h"
+
+using namespace opencog;
+
+UREBudget::UREBudget(const UREConfig& config, const AtomSpace& kb_as)
+	: _config(config), _kb_as(kb_as)
+{
+	start();
+}
+
+void UREBudget::start()
+{
+	_start_time = std::chrono::steady_clock::now();
+	_start_kb_size = _kb_as.get_size();
+	_suspended_time = std::chrono::steady_clock::duration::zero();
+	_suspended = false;
+	start_slice(0, -1, -1);
+}
+
+void UREBudget::start_slice(int iteration, int max_steps, int max_ms)
+{
+	auto now = std::chrono::steady_clock::now();
+	if (_suspended) {
+		_suspended_time += now - _suspend_time;
+		_suspended = false;
+	}
+
+	_slice_start = iteration;
+	_slice_max_steps = max_steps;
+	_slice_timed = 0 <= max_ms;
+	if (_slice_timed)
+		_slice_deadline = now + std::chrono::milliseconds(max_ms);
+}
+
+bool UREBudget::slice_exceeded(int iteration) const
+{
+	if (0 <= _slice_max_steps and _slice_start + _slice_max_steps <= iteration)
+		return true;
+	return _slice_timed and _slice_deadline <= std::chrono::steady_clock::now();
+}
+
+void UREBudget::end_slice()
+{
+	if (_suspended)
+		return;
+	_suspend_time = std::chrono::steady_clock::now();
+	_suspended = true;
+}
+
+bool UREBudget::exceeded(std::string& msg) const
+{
+	double max_time = _config.get_maximum_time();
+	if (0 <= max_time and max_time <= elapsed_time()) {
+		msg = "reached the maximum time";
+		return true;
+	}
+
+	int max_atoms = _config.get_maximum_atoms_created();
+	if (0 <= max_atoms and (size_t)max_atoms <= atoms_created()) {
+		msg = "reached the maximum number of atoms created";
+		return true;
+	}
+
+	double max_memory = _config.get_maximum_memory();
+	if (0 <= max_memory and max_memory <= memory_usage()) {
+		msg = "reached the maximum memory";
+		return true;
+	}
+
+	return false;
+}
+
+double UREBudget::elapsed_time() const
+{
+	auto end = _suspended ? _suspend_time : std::chrono::steady_clock::now();
+	std::chrono::duration<double> d = end - _start_time - _suspended_time;
+	return d.count();
+}
+
+size_t UREBudget::atoms_created() const
+{
+	// The knowledge base may shrink, for instance if another process
+	// removes atoms while chaining.
+	size_t kb_size = _kb_as.get_size();
+	return _start_kb_size < kb_size ? kb_size - _start_kb_size : 0;
+}
+
+double UREBudget::memory_usage()
+{
+	// Resident set size, as the end of the heap, given by
+	// getMemUsage, does not account for memory mapped allocations,
+	// and does not shrink when memory is released. It is only
+	// available on systems providing /proc.
+	std::ifstream statm("/proc/self/statm");
+	size_t size, resident;
+	if (statm >> size >> resident)
+		return resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+	return getMemUsage() / (1024.0 * 1024.0);
+}
@@ -0,0 +1,123 @@
+/*
+ * UREBudget.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_URE_BUDGET_H_
+#define _OPENCOG_URE_BUDGET_H_
+
+#include <chrono>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "UREConfig.h"
+
+namespace opencog
+{
+
+/**
+ * Keep track of the resources consumed by a chainer, wall-clock
+ * time, atoms created in the knowledge base and memory, and tell
+ * whether they exceed the budgets set in the URE configuration
+ *
+ * URE:maximum-time
+ * URE:maximum-atoms-created
+ * URE:maximum-memory
+ *
+ * All checks are cheap enough to be performed at every iteration.
+ *
+ * Chaining may also be performed in slices, each limited to a number
+ * of steps or some time, see ForwardChainer::run and
+ * BackwardChainer::run. The time elapsed between slices, while
+ * chaining is suspended, does not count toward the time budget.
+ */
+class UREBudget
+{
+public:
+	UREBudget(const UREConfig& config, const AtomSpace& kb_as);
+
+	/**
+	 * Reset the clock and the atom counter. Called at the start of
+	 * chaining.
+	 */
+	void start();
+
+	/**
+	 * Return true iff one of the budgets has been exceeded, in which
+	 * case msg is set to the cause.
+	 */
+	bool exceeded(std::string& msg) const;
+
+	/**
+	 * Start a slice of chaining, starting at the given iteration, and
+	 * limited to max_steps iterations and max_ms milliseconds,
+	 * negative meaning unlimited. Resume the clock if suspended.
+	 */
+	void start_slice(int iteration, int max_steps, int max_ms);
+
+	/**
+	 * Return true iff the current slice is over at the given
+	 * iteration.
+	 */
+	bool slice_exceeded(int iteration) const;
+
+	/**
+	 * End the current slice, suspending the clock till the next one.
+	 */
+	void end_slice();
+
+	/**
+	 * Elapsed seconds since start, excluding the time spent suspended
+	 * between slices.
+	 */
+	double elapsed_time() const;
+
+	/**
+	 * Number of atoms added to the knowledge base since start.
+	 */
+	size_t atoms_created() const;
+
+	/**
+	 * Memory used by the process, in megabytes, that is its resident
+	 * set size where available.
+	 */
+	static double memory_usage();
+
+private:
+	const UREConfig& _config;
+	const AtomSpace& _kb_as;
+
+	std::chrono::steady_clock::time_point _start_time;
+	size_t _start_kb_size;
+
+	// Time spent suspended between slices, and start of the current
+	// suspension if suspended
+	std::chrono::steady_clock::duration _suspended_time;
+	std::chrono::steady_clock::time_point _suspend_time;
+	bool _suspended;
+
+	// Limits of the current slice
+	int _slice_start;
+	int _slice_max_steps;
+	bool _slice_timed;
+	std::chrono::steady_clock::time_point _slice_deadline;
+};
+
+} // ~namespace opencog
+
+#endif /* _OPENCOG_URE_BUDGET_H_ */
@@ -21,10 +21,13 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+
 #include "UREConfig.h"
 
 #include <opencog/util/oc_assert.h>
 #include <opencog/atoms/core/NumberNode.h>
+#include <opencog/atoms/truthvalue/SimpleTruthValue.h>
 #include <opencog/atomspaceutils/AtomSpaceUtils.h>
 
 using namespace std;
@@ -41,28 +44,186 @@ const std::string UREConfig::jobs_name =
 	"URE:jobs";
 const std::string UREConfig::expansion_pool_size_name =
 	"URE:expansion-pool-size";
+const std::string UREConfig::max_time_name =
+	"URE:maximum-time";
+const std::string UREConfig::max_atoms_created_name =
+	"URE:maximum-atoms-created";
+const std::string UREConfig::max_memory_name =
+	"URE:maximum-memory";
+const std::string UREConfig::trace_sampling_name =
+	"URE:trace-sampling";
+const std::string UREConfig::trace_async_name =
+	"URE:trace-async";
+const std::string UREConfig::rule_tv_learning_name =
+	"URE:rule-tv-learning";
+const std::string UREConfig::rule_tv_persistence_name =
+	"URE:rule-tv-persistence";
 const std::string UREConfig::fc_retry_exhausted_sources_name =
 	"URE:FC:retry-exhausted-sources";
 const std::string UREConfig::fc_full_rule_application_name =
 	"URE:FC:full-rule-application";
+const std::string UREConfig::fc_results_only_name =
+	"URE:FC:results-only";
 const std::string UREConfig::bc_max_bit_size_name =
 	"URE:BC:maximum-bit-size";
+const std::string UREConfig::bc_bit_low_watermark_name =
+	"URE:BC:bit-low-watermark";
 const std::string UREConfig::bc_mm_complexity_penalty_name =
 	"URE:BC:MM:complexity-penalty";
 const std::string UREConfig::bc_mm_compressiveness_name =
 	"URE:BC:MM:compressiveness";
-
-UREConfig::UREConfig(AtomSpace& as, const Handle& rbs) : _as(as)
+const std::string UREConfig::bc_fulfillment_jobs_name =
+	"URE:BC:fulfillment-jobs";
+const std::string UREConfig::bc_fulfillment_queue_size_name =
+	"URE:BC:fulfillment-queue-size";
+const std::string UREConfig::bc_fulfillment_cache_name =
+	"URE:BC:fulfillment-cache";
+const std::string UREConfig::bc_goal_tabling_name =
+	"URE:BC:goal-tabling";
+
+UREConfig::UREConfig(AtomSpace& as, const Handle& rbs) : _as(as), _rbs(rbs)
 {
 	if (Handle::UNDEFINED == rbs)
 		throw RuntimeException(TRACE_INFO,
 			"UREConfig - invalid rulebase specified!");
 
+	fetch_rules(rbs);
 	fetch_common_parameters(rbs);
 	fetch_fc_parameters(rbs);
 	fetch_bc_parameters(rbs);
 }
 
+UREConfig::UREConfig(const UREConfig& other)
+	: _as(other._as),
+	  _rbs(other._rbs),
+	  _common_params(other._common_params),
+	  _fc_params(other._fc_params),
+	  _bc_params(other._bc_params)
+{
+	// The copied rule set is already ordered
+	_common_params.rules.clear();
+	for (const RulePtr& rule : other._common_params.rules)
+		_common_params.rules.push_back(createRule(*rule));
+}
+
+UREConfig::UREConfig(AtomSpace& as, const std::string& filename) : _as(as)
+{
+	RuleBaseReader reader(as, filename);
+	_rbs = reader.get_atom();
+	load_parameters(reader);
+
+	// Parameter links of the saved values. Those of the atomspace are
+	// left untouched, thus the file is refused if they hold other
+	// values, before anything but the atom table has been loaded.
+	HandleSeq params = parameter_links();
+	for (const Handle& param : params) {
+		Handle other = conflicting_parameter_link(param);
+		if (other)
+			throw RuntimeException(TRACE_INFO,
+				"UREConfig - %s conflicts with parameter %s of the atomspace",
+				filename.c_str(), other->to_short_string().c_str());
+	}
+	for (const Handle& param : params) {
+		bool is_new = param->get_type() == EVALUATION_LINK
+			and not as.get_atom(param);
+		Handle link = as.add_atom(param);
+		if (is_new)
+			link->setTruthValue(param->getTruthValue());
+	}
+
+	// Links involving the rule-based system, memberships and others,
+	// whose atoms have already been added, with their TVs
+	uint32_t link_count = reader.get_uint();
+	for (uint32_t i = 0; i < link_count; i++) {
+		Handle link = reader.get_atom();
+		link->setTruthValue(reader.get_tv());
+	}
+
+	// Rules, the membership TV is set to the saved rule TV, so that
+	// the rule picks it up
+	uint32_t rule_count = reader.get_uint();
+	for (uint32_t i = 0; i < rule_count; i++) {
+		Handle alias = reader.get_atom();
+		Handle rule = reader.get_atom();
+		TruthValuePtr tv = reader.get_tv();
+		if (alias->getIncomingSetByType(DEFINE_LINK).empty())
+			as.add_link(DEFINE_LINK, alias, rule);
+		as.add_link(MEMBER_LINK, alias, _rbs)->setTruthValue(tv);
+		_common_params.rules.insert(createRule(alias, rule, _rbs));
+	}
+
+	ure_logger().debug() << "Rule-base " << _rbs->get_name()
+	                     << " loaded from " << filename;
+}
+
+void UREConfig::save(const std::string& filename) const
+{
+	RuleBaseWriter writer;
+	writer.put_atom(_rbs);
+	save_parameters(writer);
+
+	// Parameter links are left out, as they are rebuilt from the
+	// saved values at loading
+	HandleSeq params = parameter_links();
+	HandleSeq links;
+	for (const Handle& link : _rbs->getIncomingSet()) {
+		auto same_param = [&](const Handle& param) {
+			return link->get_type() == param->get_type()
+				and link->get_arity() == param->get_arity()
+				and content_eq(link->getOutgoingAtom(0), param->getOutgoingAtom(0))
+				and link->getOutgoingAtom(1) == _rbs;
+		};
+		if (std::none_of(params.begin(), params.end(), same_param))
+			links.push_back(link);
+	}
+
+	writer.put_uint(links.size());
+	for (const Handle& link : links) {
+		writer.put_atom(link);
+		writer.put_tv(link->getTruthValue());
+	}
+
+	writer.put_uint(_common_params.rules.size());
+	for (const RulePtr& rule : _common_params.rules) {
+		writer.put_atom(rule->get_alias());
+		writer.put_atom(rule->get_rule());
+		writer.put_tv(rule->get_tv());
+	}
+
+	writer.write(filename);
+}
+
+void UREConfig::save_rule_bodies(RuleBaseWriter& writer) const
+{
+	writer.put_uint(_common_params.rules.size());
+	for (const RulePtr& rule : _common_params.rules) {
+		writer.put_atom(rule->get_alias());
+		writer.put_atom(rule->get_rule());
+	}
+}
+
+bool UREConfig::same_rule_bodies(RuleBaseReader& reader) const
+{
+	const RuleSet& rules = _common_params.rules;
+	uint32_t rule_count = reader.get_uint();
+	bool same = rule_count == rules.size();
+	for (uint32_t i = 0; i < rule_count; i++) {
+		Handle alias = reader.get_atom();
+		Handle body = reader.get_atom();
+		auto same_rule = [&](const RulePtr& rule) {
+			return content_eq(rule->get_alias(), alias)
+				and content_eq(rule->get_rule(), body);
+		};
+		same = same and std::any_of(rules.begin(), rules.end(), same_rule);
+	}
+	return same;
+}
+
+const Handle& UREConfig::get_rbs() const
+{
+	return _rbs;
+}
+
 const RuleSet& UREConfig::get_rules() const
 {
 	return _common_params.rules;
@@ -93,6 +254,41 @@ int UREConfig::get_expansion_pool_size() const
 	return _common_params.expansion_pool_size;
 }
 
+double UREConfig::get_maximum_time() const
+{
+	return _common_params.max_time;
+}
+
+int UREConfig::get_maximum_atoms_created() const
+{
+	return _common_params.max_atoms_created;
+}
+
+double UREConfig::get_maximum_memory() const
+{
+	return _common_params.max_memory;
+}
+
+double UREConfig::get_trace_sampling() const
+{
+	return _common_params.trace_sampling;
+}
+
+bool UREConfig::get_trace_async() const
+{
+	return _common_params.trace_async;
+}
+
+bool UREConfig::get_rule_tv_learning() const
+{
+	return _common_params.rule_tv_learning;
+}
+
+bool UREConfig::get_rule_tv_persistence() const
+{
+	return _common_params.rule_tv_persistence;
+}
+
 bool UREConfig::get_retry_exhausted_sources() const
 {
 	return _fc_params.retry_exhausted_sources;
@@ -103,11 +299,21 @@ bool UREConfig::get_full_rule_application() const
 	return _fc_params.full_rule_application;
 }
 
+bool UREConfig::get_results_only() const
+{
+	return _fc_params.results_only;
+}
+
 double UREConfig::get_max_bit_size() const
 {
 	return _bc_params.max_bit_size;
 }
 
+double UREConfig::get_bit_low_watermark() const
+{
+	return _bc_params.bit_low_watermark;
+}
+
 double UREConfig::get_mm_complexity_penalty() const
 {
 	return _bc_params.mm_complexity_penalty;
@@ -118,6 +324,26 @@ double UREConfig::get_mm_compressiveness() const
 	return _bc_params.mm_compressiveness;
 }
 
+int UREConfig::get_fulfillment_jobs() const
+{
+	return _bc_params.fulfillment_jobs;
+}
+
+int UREConfig::get_fulfillment_queue_size() const
+{
+	return _bc_params.fulfillment_queue_size;
+}
+
+bool UREConfig::get_fulfillment_cache() const
+{
+	return _bc_params.fulfillment_cache;
+}
+
+bool UREConfig::get_goal_tabling() const
+{
+	return _bc_params.goal_tabling;
+}
+
 std::string UREConfig::get_maximum_iterations_str() const
 {
 	if (_common_params.max_iter < 0)
@@ -145,6 +371,41 @@ void UREConfig::set_expansion_pool_size(int eps)
 	_common_params.expansion_pool_size = eps;
 }
 
+void UREConfig::set_maximum_time(double mt)
+{
+	_common_params.max_time = mt;
+}
+
+void UREConfig::set_maximum_atoms_created(int mac)
+{
+	_common_params.max_atoms_created = mac;
+}
+
+void UREConfig::set_maximum_memory(double mm)
+{
+	_common_params.max_memory = mm;
+}
+
+void UREConfig::set_trace_sampling(double ts)
+{
+	_common_params.trace_sampling = ts;
+}
+
+void UREConfig::set_trace_async(bool ta)
+{
+	_common_params.trace_async = ta;
+}
+
+void UREConfig::set_rule_tv_learning(bool rtl)
+{
+	_common_params.rule_tv_learning = rtl;
+}
+
+void UREConfig::set_rule_tv_persistence(bool rtp)
+{
+	_common_params.rule_tv_persistence = rtp;
+}
+
 void UREConfig::set_retry_exhausted_sources(bool rs)
 {
 	_fc_params.retry_exhausted_sources = rs;
@@ -155,6 +416,21 @@ void UREConfig::set_full_rule_application(bool rs)
 	_fc_params.full_rule_application = rs;
 }
 
+void UREConfig::set_results_only(bool ro)
+{
+	_fc_params.results_only = ro;
+}
+
+void UREConfig::set_max_bit_size(int mbs)
+{
+	_bc_params.max_bit_size = mbs;
+}
+
+void UREConfig::set_bit_low_watermark(double lw)
+{
+	_bc_params.bit_low_watermark = lw;
+}
+
 void UREConfig::set_mm_complexity_penalty(double mm_cp)
 {
 	_bc_params.mm_complexity_penalty = mm_cp;
@@ -165,6 +441,26 @@ void UREConfig::set_mm_compressiveness(double mm_cpr)
 	_bc_params.mm_complexity_penalty = mm_cpr;
 }
 
+void UREConfig::set_fulfillment_jobs(int jobs)
+{
+	_bc_params.fulfillment_jobs = jobs;
+}
+
+void UREConfig::set_fulfillment_queue_size(int size)
+{
+	_bc_params.fulfillment_queue_size = size;
+}
+
+void UREConfig::set_fulfillment_cache(bool fc)
+{
+	_bc_params.fulfillment_cache = fc;
+}
+
+void UREConfig::set_goal_tabling(bool gt)
+{
+	_bc_params.goal_tabling = gt;
+}
+
 HandleSeq UREConfig::fetch_rule_names(const Handle& rbs)
 {
 	// Retrieve rules
@@ -182,7 +478,7 @@ HandleSeq UREConfig::fetch_rule_names(const Handle& rbs)
 	return rule_names;
 }
 
-void UREConfig::fetch_common_parameters(const Handle& rbs)
+void UREConfig::fetch_rules(const Handle& rbs)
 {
 	// Retrieve the rules (MemberLinks) and instantiate them
 	for (const Handle& rule_name : fetch_rule_names(rbs))
@@ -195,7 +491,10 @@ void UREConfig::fetch_common_parameters(const Handle& rbs)
 
 		_common_params.rules.insert(createRule(rule_name, rbs));
 	}
+}
 
+void UREConfig::fetch_common_parameters(const Handle& rbs)
+{
 	// Fetch maximum number of iterations
 	_common_params.max_iter = fetch_num_param(max_iter_name, rbs, 100);
 
@@ -209,6 +508,23 @@ void UREConfig::fetch_common_parameters(const Handle& rbs)
 	// Fetch production application ratio
 	_common_params.expansion_pool_size =
 		fetch_num_param(expansion_pool_size_name, rbs, 1);
+
+	// Fetch time, atoms and memory budgets
+	_common_params.max_time = fetch_num_param(max_time_name, rbs, -1);
+	_common_params.max_atoms_created =
+		fetch_num_param(max_atoms_created_name, rbs, -1);
+	_common_params.max_memory = fetch_num_param(max_memory_name, rbs, -1);
+
+	// Fetch trace parameters
+	_common_params.trace_sampling =
+		fetch_num_param(trace_sampling_name, rbs, 1);
+	_common_params.trace_async = fetch_bool_param(trace_async_name, rbs, true);
+
+	// Fetch rule TV learning parameters
+	_common_params.rule_tv_learning =
+		fetch_bool_param(rule_tv_learning_name, rbs, false);
+	_common_params.rule_tv_persistence =
+		fetch_bool_param(rule_tv_persistence_name, rbs, false);
 }
 
 void UREConfig::fetch_fc_parameters(const Handle& rbs)
@@ -218,6 +534,8 @@ void UREConfig::fetch_fc_parameters(const Handle& rbs)
 		fetch_bool_param(fc_retry_exhausted_sources_name, rbs, false);
 	_fc_params.full_rule_application =
 		fetch_bool_param(fc_full_rule_application_name, rbs, false);
+	_fc_params.results_only =
+		fetch_bool_param(fc_results_only_name, rbs, false);
 }
 
 void UREConfig::fetch_bc_parameters(const Handle& rbs)
@@ -225,6 +543,10 @@ void UREConfig::fetch_bc_parameters(const Handle& rbs)
 	// Fetch BC BIT maximum size parameter
 	_bc_params.max_bit_size = fetch_num_param(bc_max_bit_size_name, rbs, -1);
 
+	// Fetch BC BIT low watermark parameter
+	_bc_params.bit_low_watermark =
+		fetch_num_param(bc_bit_low_watermark_name, rbs, 1);
+
 	// Fetch BC Mixture Model complexity penalty parameter
 	_bc_params.mm_complexity_penalty =
 		fetch_num_param(bc_mm_complexity_penalty_name, rbs, 0);
@@ -232,6 +554,18 @@ void UREConfig::fetch_bc_parameters(const Handle& rbs)
 	// Fetch BC Mixture Model compressiveness parameter
 	_bc_params.mm_compressiveness =
 		fetch_num_param(bc_mm_compressiveness_name, rbs, 1);
+
+	// Fetch BC fulfillment pipeline parameters
+	_bc_params.fulfillment_jobs =
+		fetch_num_param(bc_fulfillment_jobs_name, rbs, 0);
+	_bc_params.fulfillment_queue_size =
+		fetch_num_param(bc_fulfillment_queue_size_name, rbs, 16);
+	_bc_params.fulfillment_cache =
+		fetch_bool_param(bc_fulfillment_cache_name, rbs, false);
+
+	// Fetch BC goal tabling parameter
+	_bc_params.goal_tabling =
+		fetch_bool_param(bc_goal_tabling_name, rbs, false);
 }
 
 HandleSeq UREConfig::fetch_execution_outputs(const Handle& schema,
@@ -318,3 +652,142 @@ bool UREConfig::fetch_bool_param(const string& pred_name,
 	log_param_value(input, pred_name, default_value, true);
 	return default_value;
 }
+
+HandleSeq UREConfig::parameter_links() const
+{
+	auto num_param = [&](const std::string& name, double value) {
+		return createLink(EXECUTION_LINK,
+		                  createNode(SCHEMA_NODE, std::string(name)), _rbs,
+		                  HandleCast(createNumberNode(value)));
+	};
+	auto bool_param = [&](const std::string& name, bool value) {
+		Handle eval = createLink(EVALUATION_LINK,
+		                         createNode(PREDICATE_NODE, std::string(name)),
+		                         _rbs);
+		eval->setTruthValue(SimpleTruthValue::createTV(value ? 1 : 0, 1));
+		return eval;
+	};
+
+	return {
+		// Common
+		num_param(max_iter_name, _common_params.max_iter),
+		num_param(complexity_penalty_name, _common_params.complexity_penalty),
+		num_param(jobs_name, _common_params.jobs),
+		num_param(expansion_pool_size_name, _common_params.expansion_pool_size),
+		num_param(max_time_name, _common_params.max_time),
+		num_param(max_atoms_created_name, _common_params.max_atoms_created),
+		num_param(max_memory_name, _common_params.max_memory),
+		num_param(trace_sampling_name, _common_params.trace_sampling),
+		bool_param(trace_async_name, _common_params.trace_async),
+		bool_param(rule_tv_learning_name, _common_params.rule_tv_learning),
+		bool_param(rule_tv_persistence_name, _common_params.rule_tv_persistence),
+
+		// FC
+		bool_param(fc_retry_exhausted_sources_name,
+		           _fc_params.retry_exhausted_sources),
+		bool_param(fc_full_rule_application_name,
+		           _fc_params.full_rule_application),
+		bool_param(fc_results_only_name, _fc_params.results_only),
+
+		// BC
+		num_param(bc_max_bit_size_name, _bc_params.max_bit_size),
+		num_param(bc_bit_low_watermark_name, _bc_params.bit_low_watermark),
+		num_param(bc_mm_complexity_penalty_name,
+		          _bc_params.mm_complexity_penalty),
+		num_param(bc_mm_compressiveness_name, _bc_params.mm_compressiveness),
+		num_param(bc_fulfillment_jobs_name, _bc_params.fulfillment_jobs),
+		num_param(bc_fulfillment_queue_size_name,
+		          _bc_params.fulfillment_queue_size),
+		bool_param(bc_fulfillment_cache_name, _bc_params.fulfillment_cache),
+		bool_param(bc_goal_tabling_name, _bc_params.goal_tabling)
+	};
+}
+
+Handle UREConfig::conflicting_parameter_link(const Handle& param) const
+{
+	const Handle& name = param->getOutgoingAtom(0);
+	Handle node = _as.get_atom(name);
+	if (not node)
+		return Handle::UNDEFINED;
+
+	if (param->get_type() == EVALUATION_LINK) {
+		Handle eval = _as.get_link(EVALUATION_LINK, node, _rbs);
+		bool value = param->getTruthValue()->get_mean() > 0.5;
+		if (eval and (eval->getTruthValue()->get_mean() > 0.5) != value)
+			return eval;
+		return Handle::UNDEFINED;
+	}
+
+	double value = NumberNodeCast(param->getOutgoingAtom(2))->get_value();
+	for (const Handle& exec : node->getIncomingSetByType(EXECUTION_LINK)) {
+		if (exec->get_arity() != 3 or exec->getOutgoingAtom(1) != _rbs)
+			continue;
+		const Handle& output = exec->getOutgoingAtom(2);
+		if (output->get_type() != NUMBER_NODE
+		    or NumberNodeCast(output)->get_value() != value)
+			return exec;
+	}
+	return Handle::UNDEFINED;
+}
+
+void UREConfig::save_parameters(RuleBaseWriter& writer) const
+{
+	// Common
+	writer.put_double(_common_params.max_iter);
+	writer.put_double(_common_params.complexity_penalty);
+	writer.put_double(_common_params.jobs);
+	writer.put_double(_common_params.expansion_pool_size);
+	writer.put_double(_common_params.max_time);
+	writer.put_double(_common_params.max_atoms_created);
+	writer.put_double(_common_params.max_memory);
+	writer.put_double(_common_params.trace_sampling);
+	writer.put_bool(_common_params.trace_async);
+	writer.put_bool(_common_params.rule_tv_learning);
+	writer.put_bool(_common_params.rule_tv_persistence);
+
+	// FC
+	writer.put_bool(_fc_params.retry_exhausted_sources);
+	writer.put_bool(_fc_params.full_rule_application);
+	writer.put_bool(_fc_params.results_only);
+
+	// BC
+	writer.put_double(_bc_params.max_bit_size);
+	writer.put_double(_bc_params.bit_low_watermark);
+	writer.put_double(_bc_params.mm_complexity_penalty);
+	writer.put_double(_bc_params.mm_compressiveness);
+	writer.put_double(_bc_params.fulfillment_jobs);
+	writer.put_double(_bc_params.fulfillment_queue_size);
+	writer.put_bool(_bc_params.fulfillment_cache);
+	writer.put_bool(_bc_params.goal_tabling);
+}
+
+void UREConfig::load_parameters(RuleBaseReader& reader)
+{
+	// Common
+	_common_params.max_iter = reader.get_double();
+	_common_params.complexity_penalty = reader.get_double();
+	_common_params.jobs = reader.get_double();
+	_common_params.expansion_pool_size = reader.get_double();
+	_common_params.max_time = reader.get_double();
+	_common_params.max_atoms_created = reader.get_double();
+	_common_params.max_memory = reader.get_double();
+	_common_params.trace_sampling = reader.get_double();
+	_common_params.trace_async = reader.get_bool();
+	_common_params.rule_tv_learning = reader.get_bool();
+	_common_params.rule_tv_persistence = reader.get_bool();
+
+	// FC
+	_fc_params.retry_exhausted_sources = reader.get_bool();
+	_fc_params.full_rule_application = reader.get_bool();
+	_fc_params.results_only = reader.get_bool();
+
+	// BC
+	_bc_params.max_bit_size = reader.get_double();
+	_bc_params.bit_low_watermark = reader.get_double();
+	_bc_params.mm_complexity_penalty = reader.get_double();
+	_bc_params.mm_compressiveness = reader.get_double();
+	_bc_params.fulfillment_jobs = reader.get_double();
+	_bc_params.fulfillment_queue_size = reader.get_double();
+	_bc_params.fulfillment_cache = reader.get_bool();
+	_bc_params.goal_tabling = reader.get_bool();
+}
@@ -29,6 +29,7 @@
 #include <opencog/atomspace/AtomSpace.h>
 
 #include "URELogger.h"
+#include "RuleBaseFile.h"
 
 namespace opencog {
 
@@ -53,10 +54,26 @@ public:
 	// rbs is a Handle pointing to a rule-based system is as
 	UREConfig(AtomSpace& as, const Handle& rbs);
 
+	// Load the rule base and its configuration from a file written
+	// by save. The parameters are read directly from the file, and
+	// the atoms of the rule base, that is its rules, their
+	// definitions and memberships, and its parameter links, are added
+	// to as. Throw a RuntimeException if the file cannot be read, or
+	// if as already holds parameter links of the rule base with other
+	// values.
+	UREConfig(AtomSpace& as, const std::string& filename);
+
+	// Copy the parameters and the rules. Rules are copied rather
+	// than shared, as chainers may modify them, see RuleBaseCache.
+	UREConfig(const UREConfig& other);
+
 	///////////////
 	// Accessors //
 	///////////////
 
+	// Rule-based system
+	const Handle& get_rbs() const;
+
 	// Common
 	const RuleSet& get_rules() const;
 	RuleSet& get_rules();
@@ -64,13 +81,26 @@ public:
 	double get_complexity_penalty() const;
 	int get_jobs() const;
 	int get_expansion_pool_size() const;
+	double get_maximum_time() const;
+	int get_maximum_atoms_created() const;
+	double get_maximum_memory() const;
+	double get_trace_sampling() const;
+	bool get_trace_async() const;
+	bool get_rule_tv_learning() const;
+	bool get_rule_tv_persistence() const;
 	// FC
 	bool get_retry_exhausted_sources() const;
 	bool get_full_rule_application() const;
+	bool get_results_only() const;
 	// BC
 	double get_max_bit_size() const;
+	double get_bit_low_watermark() const;
 	double get_mm_complexity_penalty() const;
 	double get_mm_compressiveness() const;
+	int get_fulfillment_jobs() const;
+	int get_fulfillment_queue_size() const;
+	bool get_fulfillment_cache() const;
+	bool get_goal_tabling() const;
 
 	// Display
 	std::string get_maximum_iterations_str() const; // "+inf" if negative
@@ -85,12 +115,45 @@ public:
 	void set_complexity_penalty(double);
 	void set_jobs(int);
 	void set_expansion_pool_size(int);
+	void set_maximum_time(double);
+	void set_maximum_atoms_created(int);
+	void set_maximum_memory(double);
+	void set_trace_sampling(double);
+	void set_trace_async(bool);
+	void set_rule_tv_learning(bool);
+	void set_rule_tv_persistence(bool);
 	// FC
 	void set_retry_exhausted_sources(bool);
 	void set_full_rule_application(bool);
+	void set_results_only(bool);
 	// BC
+	void set_max_bit_size(int);
+	void set_bit_low_watermark(double);
 	void set_mm_complexity_penalty(double);
 	void set_mm_compressiveness(double);
+	void set_fulfillment_jobs(int);
+	void set_fulfillment_queue_size(int);
+	void set_fulfillment_cache(bool);
+	void set_goal_tabling(bool);
+
+	///////////////////
+	// Serialization //
+	///////////////////
+
+	// Write the rule base and this configuration to a binary file,
+	// see RuleBaseFile.h. The rules are saved with their current TVs,
+	// and the parameters with their current values, in place of the
+	// parameter links of the atomspace.
+	// Throw a RuntimeException if the file cannot be written.
+	void save(const std::string& filename) const;
+
+	// Write the aliases and bodies of the rules, or read them and
+	// tell whether they are those of this configuration, so that
+	// chaining states are only restored over the same rules, see
+	// ForwardChainer::save_checkpoint and
+	// BackwardChainer::save_snapshot.
+	void save_rule_bodies(RuleBaseWriter& writer) const;
+	bool same_rule_bodies(RuleBaseReader& reader) const;
 
 	//////////////////
 	// Constants    //
@@ -114,6 +177,32 @@ public:
 	// Name of the production application ratio parameter
 	static const std::string expansion_pool_size_name;
 
+	// Name of the wall-clock time budget parameter, in seconds
+	static const std::string max_time_name;
+
+	// Name of the parameter bounding the number of atoms created in
+	// the knowledge base
+	static const std::string max_atoms_created_name;
+
+	// Name of the memory budget parameter, in megabytes
+	static const std::string max_memory_name;
+
+	// Name of the parameter controlling the fraction of trace events
+	// to record
+	static const std::string trace_sampling_name;
+
+	// Name of the PredicateNode outputting whether traces should be
+	// written in the background
+	static const std::string trace_async_name;
+
+	// Name of the PredicateNode outputting whether rule TVs should be
+	// updated from the outcomes of their applications during chaining
+	static const std::string rule_tv_learning_name;
+
+	// Name of the PredicateNode outputting whether the updated rule
+	// TVs should be written back to the rule base after chaining
+	static const std::string rule_tv_persistence_name;
+
 	// Name of the PredicateNode outputting whether sources should be
 	// retried after exhaustion
 	static const std::string fc_retry_exhausted_sources_name;
@@ -123,9 +212,17 @@ public:
 	// source.
 	static const std::string fc_full_rule_application_name;
 
+	// Name of the PredicateNode outputting whether only the results,
+	// not the per-step inference records, should be kept in memory.
+	static const std::string fc_results_only_name;
+
 	// Name of the maximum number of and-BITs in the BIT parameter
 	static const std::string bc_max_bit_size_name;
 
+	// Name of the BIT size, relative to its maximum, down to which
+	// and-BITs are evicted parameter
+	static const std::string bc_bit_low_watermark_name;
+
 	// Name of the parameter of the Mixture Model controlling how
 	// complexity affects model prior.
 	static const std::string bc_mm_complexity_penalty_name;
@@ -134,9 +231,27 @@ public:
 	// much unexplained data are compressed
 	static const std::string bc_mm_compressiveness_name;
 
+	// Name of the number of fulfillment workers parameter
+	static const std::string bc_fulfillment_jobs_name;
+
+	// Name of the maximum number of FCSs waiting for fulfillment
+	// parameter
+	static const std::string bc_fulfillment_queue_size_name;
+
+	// Name of the parameter enabling the caching of fulfillment
+	// results
+	static const std::string bc_fulfillment_cache_name;
+
+	// Name of the parameter enabling the tabling of subgoals across
+	// and-BITs, see GoalTable
+	static const std::string bc_goal_tabling_name;
+
 private:
 	AtomSpace& _as;
 
+	// Rule-based system
+	Handle _rbs;
+
 	// Parameter common to the forward and backward chainer.
 	struct CommonParameters {
 		RuleSet rules;
@@ -160,6 +275,34 @@ private:
 		// iterative forward chainer), but also then the selection is
 		// more costly. Negative means unlimited.
 		int expansion_pool_size;
+
+		// Wall-clock time budget in seconds, measured from the start
+		// of chaining. If negative then disabled.
+		double max_time;
+
+		// Maximum number of atoms the chainer may add to the
+		// knowledge base. If negative then disabled.
+		int max_atoms_created;
+
+		// Maximum memory usage of the process in megabytes. If
+		// negative then disabled.
+		double max_memory;
+
+		// Fraction, within [0, 1], of the inference trace events to
+		// record in the trace atomspace, if any.
+		double trace_sampling;
+
+		// Write the inference traces in the background
+		bool trace_async;
+
+		// Update the TVs of the rules as their applications succeed
+		// or fail during chaining, see Rule::update_tv.
+		bool rule_tv_learning;
+
+		// Write the updated rule TVs back to the MemberLinks of the
+		// rule base at the end of chaining, so that subsequent
+		// chainers start from them.
+		bool rule_tv_persistence;
 	};
 	CommonParameters _common_params;
 
@@ -171,7 +314,11 @@ private:
 		// Apply the selected rule over the entire atomspace, not just
 		// the selected source.
 		bool full_rule_application;
-};
+
+		// Only keep the results in memory, not the per-step
+		// inference records.
+		bool results_only;
+	};
 	FCParameters _fc_params;
 
 	// Parameter specific to the backward chainer.
@@ -180,6 +327,12 @@ private:
 		// and-BITs the BIT can hold. Negative means unlimited.
 		int max_bit_size;
 
+		// When the BIT exceeds its maximum size, and-BITs are evicted
+		// till its size gets down to max_bit_size * bit_low_watermark.
+		// A value below 1 leaves room for subsequent expansions,
+		// avoiding evicting at every iteration.
+		double bit_low_watermark;
+
 		// Parameter of the Mixture Model controlling how complexity
 		// affects model prior. The prior exponentially decreases
 		// w.r.t. to the complexity. Specifically
@@ -191,6 +344,25 @@ private:
 		// unexplained data are compressed. The compressed unexplained
 		// data are added to the model complexity.
 		double mm_compressiveness;
+
+		// Number of workers running FCSs in the background while
+		// the BIT keeps being expanded. Zero means that FCSs are
+		// run synchronously, right after expansion.
+		int fulfillment_jobs;
+
+		// Maximum number of FCSs waiting for fulfillment, beyond
+		// which the expansion is blocked.
+		int fulfillment_queue_size;
+
+		// Whether the results of running an FCS are cached, so that
+		// it is not run again unless the knowledge base has changed
+		// in the meantime. Disabled by default, as TV updates made
+		// outside of the backward chainer go unnoticed.
+		bool fulfillment_cache;
+
+		// Whether the expansions of subgoals, and whether they have
+		// led to proofs, are shared across and-BITs, see GoalTable.
+		bool goal_tabling;
 	};
 	BCParameters _bc_params;
 
@@ -202,6 +374,10 @@ private:
 	//    <rbs>
 	HandleSeq fetch_rule_names(const Handle& rbs);
 
+	// Fetch from the atomspace the rules of a given rule-based system
+	// and instantiate them
+	void fetch_rules(const Handle& rbs);
+
 	// Fetch from the atomspace all parameters common to the forward
 	// and backward chainer
 	void fetch_common_parameters(const Handle& rbs);
@@ -212,6 +388,20 @@ private:
 	// Fetch from the atomspace all backward chainer parameters
 	void fetch_bc_parameters(const Handle& rbs);
 
+	// Build, outside of any atomspace, the ExecutionLinks and
+	// EvaluationLinks holding the current parameter values, as
+	// fetched by the methods below.
+	HandleSeq parameter_links() const;
+
+	// Return a link of the atomspace holding the parameter of param,
+	// one of the links above, with another value, or
+	// Handle::UNDEFINED if there is none.
+	Handle conflicting_parameter_link(const Handle& param) const;
+
+	// Write or read all parameters, in the same order
+	void save_parameters(RuleBaseWriter& writer) const;
+	void load_parameters(RuleBaseReader& reader);
+
 	// Given <schema>, an <input> and optionally an output <type> (or
 	// subtype), return the <output>s in
 	//
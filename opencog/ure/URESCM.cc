@@ -24,6 +24,7 @@
 #ifdef HAVE_GUILE
 
 #include <opencog/ure/URELogger.h>
+#include <opencog/ure/ResultStream.h>
 #include <opencog/guile/SchemeModule.h>
 
 namespace opencog {
@@ -45,6 +46,13 @@ protected:
 	 *                     chaining will be applied.  If the set link is
 	 *                     empty, chaining will be invoked on the entire
 	 *                     atomspace.
+	 * @param results_anchor If not a ListLink, results are attached to
+	 *                     it as (MemberLink <result> <results_anchor>).
+	 * @param results_as   AtomSpace where to attach the results to
+	 *                     results_anchor, as soon as they are
+	 *                     derived. If disabled they are attached in
+	 *                     the knowledge base once chaining is over,
+	 *                     so as not to alter it while chaining.
 	 *
 	 * @return             A SetLink containing the results of FC inference.
 	 */
@@ -53,7 +61,10 @@ protected:
 	                           Handle vardecl,
 	                           bool trace_enabled,
 	                           AtomSpace *trace_as,
-	                           Handle focus_set);
+	                           Handle focus_set,
+	                           Handle results_anchor,
+	                           bool results_enabled,
+	                           AtomSpace* results_as);
 
 	/**
 	 * The scheme (cog-mandatory-args-bc) function calls this, to
@@ -68,6 +79,13 @@ protected:
 	 *                     chaining will be applied.  If the set link is
 	 *                     empty, chaining will be invoked on the entire
 	 *                     atomspace.
+	 * @param results_anchor If not a ListLink, results are attached to
+	 *                     it as (MemberLink <result> <results_anchor>).
+	 * @param results_as   AtomSpace where to attach the results to
+	 *                     results_anchor, as soon as they are
+	 *                     derived. If disabled they are attached in
+	 *                     the knowledge base once chaining is over,
+	 *                     so as not to alter it while chaining.
 	 *
 	 * @return             A SetLink containing the results of FC inference.
 	 */
@@ -78,10 +96,83 @@ protected:
 	                            AtomSpace* trace_as,
 	                            bool control_enabled,
 	                            AtomSpace* control_as,
-	                            Handle focus_set);
+	                            Handle focus_set,
+	                            Handle results_anchor,
+	                            bool results_enabled,
+	                            AtomSpace* results_as);
+
+	/**
+	 * The scheme (cog-mandatory-args-bc-batch) function calls this,
+	 * to run many backward chaining queries in parallel, see
+	 * BatchBackwardChainer.
+	 *
+	 * @param rbs          A node, holding the name of the rulebase.
+	 * @param targets      The targets of the queries.
+	 * @param vardecls     The variable declarations of the targets,
+	 *                     either empty, or one per target, a ListLink
+	 *                     meaning none.
+	 * @param control_as   AtomSpace where to find the inference control rules
+	 * @param jobs         Number of queries run in parallel, 0 meaning
+	 *                     as many as hardware threads.
+	 * @param maximum_iterations Maximum number of iterations per
+	 *                     query, negative meaning that of the rulebase.
+	 * @param maximum_time Time budget in seconds per query, negative
+	 *                     meaning that of the rulebase.
+	 *
+	 * @return             A ListLink containing a SetLink of results per
+	 *                     target, in the order of the targets.
+	 */
+	Handle do_batch_backward_chaining(Handle rbs,
+	                                  HandleSeq targets,
+	                                  HandleSeq vardecls,
+	                                  bool control_enabled,
+	                                  AtomSpace* control_as,
+	                                  int jobs,
+	                                  int maximum_iterations,
+	                                  double maximum_time);
+
+	/**
+	 * Connect a result stream to an anchor, so that each new result
+	 * gets attached to it in results_as, as (MemberLink <result>
+	 * <anchor>), as soon as it is derived. Do nothing if anchor is a
+	 * ListLink or results_as is null.
+	 */
+	void stream_to_anchor(ResultStream& stream, AtomSpace* results_as,
+	                      const Handle& anchor);
+
+	/**
+	 * Attach the results of a chainer, a SetLink, to an anchor in
+	 * the given atomspace, unless they have been streamed to it
+	 * already, that is results_as is not null. Return the results.
+	 */
+	Handle attach_to_anchor(const Handle& results, AtomSpace* as,
+	                        AtomSpace* results_as, const Handle& anchor);
 
 	Handle get_rulebase_rules(Handle rbs);
 
+	/**
+	 * The scheme (cog-ure-save-rule-base) function calls this, to
+	 * write the rule base and its configuration to a binary file,
+	 * see UREConfig::save.
+	 *
+	 * @param rbs          A node, holding the name of the rulebase.
+	 * @param filename     Path of the file to write.
+	 *
+	 * @return             rbs
+	 */
+	Handle save_rule_base(Handle rbs, const std::string& filename);
+
+	/**
+	 * The scheme (cog-ure-load-rule-base) function calls this, to
+	 * load a rule base written by cog-ure-save-rule-base in the
+	 * current atomspace, see RuleBaseCache::load.
+	 *
+	 * @param filename     Path of the file to read.
+	 *
+	 * @return             The node of the loaded rulebase.
+	 */
+	Handle load_rule_base(const std::string& filename);
+
 	/**
 	 * Return the URE logger
 	 */
@@ -98,7 +189,9 @@ public:
 
 #include "forwardchainer/ForwardChainer.h"
 #include "backwardchainer/BackwardChainer.h"
+#include "backwardchainer/BatchBackwardChainer.h"
 #include "UREConfig.h"
+#include "RuleBaseCache.h"
 
 using namespace opencog;
 
@@ -114,8 +207,17 @@ void URESCM::init(void)
 	define_scheme_primitive("cog-mandatory-args-bc",
 		&URESCM::do_backward_chaining, this, "ure");
 
+	define_scheme_primitive("cog-mandatory-args-bc-batch",
+		&URESCM::do_batch_backward_chaining, this, "ure");
+
 	define_scheme_primitive("cog-ure-logger",
 		&URESCM::do_ure_logger, this, "ure");
+
+	define_scheme_primitive("cog-ure-save-rule-base",
+		&URESCM::save_rule_base, this, "ure");
+
+	define_scheme_primitive("cog-ure-load-rule-base",
+		&URESCM::load_rule_base, this, "ure");
 }
 
 Handle URESCM::do_forward_chaining(Handle rbs,
@@ -123,7 +225,10 @@ Handle URESCM::do_forward_chaining(Handle rbs,
                                    Handle vardecl,
                                    bool trace_enabled,
                                    AtomSpace *trace_as,
-                                   Handle focus_set_h)
+                                   Handle focus_set_h,
+                                   Handle results_anchor,
+                                   bool results_enabled,
+                                   AtomSpace* results_as)
 {
 	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-mandatory-args-fc");
 	HandleSeq focus_set = {};
@@ -135,6 +240,9 @@ Handle URESCM::do_forward_chaining(Handle rbs,
 	if (not trace_enabled)
 		trace_as = nullptr;
 
+	if (not results_enabled)
+		results_as = nullptr;
+
 	if (focus_set_h->get_type() == SET_LINK)
 		focus_set = focus_set_h->getOutgoingSet();
 	else
@@ -143,8 +251,9 @@ Handle URESCM::do_forward_chaining(Handle rbs,
 			"URESCM::do_forward_chaining - focus set should be SET_LINK type!");
 
 	ForwardChainer fc(*as, rbs, source, vardecl, trace_as, focus_set);
+	stream_to_anchor(fc.get_result_stream(), results_as, results_anchor);
 	fc.do_chain();
-	return fc.get_results();
+	return attach_to_anchor(fc.get_results(), as, results_as, results_anchor);
 }
 
 Handle URESCM::do_backward_chaining(Handle rbs,
@@ -154,7 +263,10 @@ Handle URESCM::do_backward_chaining(Handle rbs,
                                     AtomSpace *trace_as,
                                     bool control_enabled,
                                     AtomSpace *control_as,
-                                    Handle focus_link)
+                                    Handle focus_link,
+                                    Handle results_anchor,
+                                    bool results_enabled,
+                                    AtomSpace* results_as)
 {
 	// A ListLink means that the variable declaration is undefined
 	if (vardecl->get_type() == LIST_LINK)
@@ -166,12 +278,81 @@ Handle URESCM::do_backward_chaining(Handle rbs,
 	if (not control_enabled)
 		control_as = nullptr;
 
+	if (not results_enabled)
+		results_as = nullptr;
+
 	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-mandatory-args-bc");
 	BackwardChainer bc(*as, rbs, target, vardecl, trace_as, control_as, focus_link);
+	stream_to_anchor(bc.get_result_stream(), results_as, results_anchor);
 
 	bc.do_chain();
 
-	return bc.get_results();
+	return attach_to_anchor(bc.get_results(), as, results_as, results_anchor);
+}
+
+Handle URESCM::do_batch_backward_chaining(Handle rbs,
+                                          HandleSeq targets,
+                                          HandleSeq vardecls,
+                                          bool control_enabled,
+                                          AtomSpace *control_as,
+                                          int jobs,
+                                          int maximum_iterations,
+                                          double maximum_time)
+{
+	// A ListLink means that the variable declaration is undefined
+	for (Handle& vardecl : vardecls)
+		if (vardecl->get_type() == LIST_LINK)
+			vardecl = Handle::UNDEFINED;
+
+	if (not control_enabled)
+		control_as = nullptr;
+
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-mandatory-args-bc-batch");
+	BatchBackwardChainer bbc(*as, rbs, targets, vardecls, control_as);
+	bbc.set_jobs(std::max(jobs, 0));
+	bbc.set_maximum_iterations(maximum_iterations);
+	bbc.set_maximum_time(maximum_time);
+
+	bbc.do_chain();
+
+	return bbc.get_results();
+}
+
+void URESCM::stream_to_anchor(ResultStream& stream, AtomSpace* results_as,
+                              const Handle& anchor)
+{
+	// A ListLink means that there is no anchor. Without a separate
+	// atomspace the results are only attached once chaining is over,
+	// as adding member links to the knowledge base would alter the
+	// course of chaining.
+	if (anchor->get_type() == LIST_LINK or not results_as)
+		return;
+
+	stream.set_callback([results_as, anchor](const ResultEvent& re) {
+			results_as->add_link(MEMBER_LINK, re.product, anchor); });
+}
+
+Handle URESCM::attach_to_anchor(const Handle& results, AtomSpace* as,
+                                AtomSpace* results_as, const Handle& anchor)
+{
+	if (anchor->get_type() != LIST_LINK and not results_as)
+		for (const Handle& result : results->getOutgoingSet())
+			as->add_link(MEMBER_LINK, result, anchor);
+	return results;
+}
+
+Handle URESCM::save_rule_base(Handle rbs, const std::string& filename)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-ure-save-rule-base");
+	AtomSpace& rb_as = rbs->getAtomSpace() ? *rbs->getAtomSpace() : *as;
+	RuleBaseCache::instance().get(rb_as, rbs)->save(filename);
+	return rbs;
+}
+
+Handle URESCM::load_rule_base(const std::string& filename)
+{
+	AtomSpace *as = SchemeSmob::ss_get_env_as("cog-ure-load-rule-base");
+	return RuleBaseCache::instance().load(*as, filename);
 }
 
 Logger* URESCM::do_ure_logger()
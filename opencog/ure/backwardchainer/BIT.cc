@@ -20,14 +20,15 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+
 #include <boost/range/algorithm/binary_search.hpp>
-#include <boost/range/algorithm/lower_bound.hpp>
 #include <boost/range/algorithm/reverse.hpp>
 #include <boost/range/algorithm/unique.hpp>
-#include <boost/range/algorithm/find.hpp>
 #include <boost/range/algorithm/sort.hpp>
 #include <boost/range/algorithm_ext/erase.hpp>
 #include <boost/algorithm/cxx11/all_of.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -36,6 +37,7 @@
 
 #include <opencog/util/random.h>
 #include <opencog/util/algorithm.h>
+#include <opencog/util/exceptions.h>
 #include <opencog/atoms/core/FindUtils.h>
 #include <opencog/atoms/core/TypeUtils.h>
 #include <opencog/atoms/grounded/LibraryManager.h>
@@ -89,7 +91,7 @@ std::string	BITNode::to_string(const std::string& indent) const
 
 AndBIT::AndBIT() : complexity(0), exhausted(false), queried_as(nullptr) {}
 
-AndBIT::AndBIT(AtomSpace& bit_as, const Handle& target, Handle vardecl,
+AndBIT::AndBIT(const Handle& target, Handle vardecl,
                const BITNodeFitness& fitness, const AtomSpace* qas)
 	: exhausted(false), queried_as(qas)
 {
@@ -107,7 +109,7 @@ AndBIT::AndBIT(AtomSpace& bit_as, const Handle& target, Handle vardecl,
 	vardecl = filter_vardecl(vardecl, body); // remove useless vardecl
 	if (vardecl)
 		bl.insert(bl.begin(), vardecl);
-	fcs = bit_as.add_link(BIND_LINK, std::move(bl));
+	fcs = createLink(std::move(bl), BIND_LINK);
 
 	// Insert the initial BITNode and initialize the AndBIT complexity
 	auto it = insert_bitnode(target, fitness);
@@ -148,7 +150,7 @@ AndBIT AndBIT::expand(const Handle& leaf,
 	return AndBIT(new_fcs, new_cpx, queried_as);
 }
 
-BITNode* AndBIT::select_leaf()
+BITNode* AndBIT::select_leaf(RandGen& rng)
 {
 	// Generate the distribution over target leaves according to the
 	// BIT-node fitnesses. The higher the fitness the lower the chance
@@ -167,7 +169,20 @@ BITNode* AndBIT::select_leaf()
 
 	// If well defined then sample according to it
 	LeafDistribution dist(weights.begin(), weights.end());
-	return &rand_element(leaf2bitnode, dist).second;
+	return &std::next(leaf2bitnode.begin(), dist(rng))->second;
+}
+
+AndBIT AndBIT::leaf_copy(const Handle& leaf) const
+{
+	AndBIT copy;
+	copy.fcs = fcs;
+	copy.complexity = complexity;
+	copy.exhausted = exhausted;
+	copy.queried_as = queried_as;
+	auto it = leaf2bitnode.find(leaf);
+	if (it != leaf2bitnode.end())
+		copy.leaf2bitnode.insert(*it);
+	return copy;
 }
 
 void AndBIT::reset_exhausted()
@@ -182,7 +197,7 @@ bool AndBIT::has_cycle() const
 	return has_cycle(BindLinkCast(fcs)->get_implicand()[0]);
 }
 
-bool AndBIT::has_cycle(const Handle& h, HandleSet ancestors) const
+bool AndBIT::has_cycle(const Handle& h, Ancestors ancestors) const
 {
 	if (h->get_type() == EXECUTION_OUTPUT_LINK) {
 		Handle arg = h->getOutgoingAtom(1);
@@ -225,7 +240,7 @@ bool AndBIT::has_cycle(const Handle& h, HandleSet ancestors) const
 
 bool AndBIT::operator==(const AndBIT& andbit) const
 {
-	return fcs == andbit.fcs;
+	return content_eq(fcs, andbit.fcs);
 }
 
 bool AndBIT::operator<(const AndBIT& andbit) const
@@ -348,7 +363,7 @@ Handle AndBIT::expand_fcs(const Handle& leaf,
 	HandleSeq noutgoings({npattern, nrewrite});
 	if (nvardecl)
 		noutgoings.insert(noutgoings.begin(), nvardecl);
-	nfcs = fcs->getAtomSpace()->add_link(BIND_LINK, std::move(noutgoings));
+	nfcs = createLink(std::move(noutgoings), BIND_LINK);
 
 	// Log expansion
 	LAZY_URE_LOG_DEBUG << "Expanded forward chainer strategy:" << std::endl
@@ -480,7 +495,6 @@ Handle AndBIT::expand_fcs_rewrite(const Handle& fcs_rewrite,
 
 	// Recursive cases
 
-	AtomSpace& as = *fcs->getAtomSpace();
 	Type t = fcs_rewrite->get_type();
 
 	if (t == EXECUTION_OUTPUT_LINK) {
@@ -492,16 +506,16 @@ Handle AndBIT::expand_fcs_rewrite(const Handle& fcs_rewrite,
 			HandleSeq args = arg->getOutgoingSet();
 			for (size_t i = 1; i < args.size(); i++)
 				args[i] = expand_fcs_rewrite(args[i], rule);
-			arg = as.add_link(LIST_LINK, std::move(args));
+			arg = createLink(std::move(args), LIST_LINK);
 		}
-		return as.add_link(EXECUTION_OUTPUT_LINK, {gsn, arg});
+		return createLink(EXECUTION_OUTPUT_LINK, gsn, arg);
 	} else if (t == SET_LINK) {
 		// If a SetLink then treat its arguments as (unordered)
 		// premises.
 		HandleSeq args = fcs_rewrite->getOutgoingSet();
 		for (size_t i = 0; i < args.size(); i++)
 			args[i] = expand_fcs_rewrite(args[i], rule);
-		return as.add_link(SET_LINK, std::move(args));
+		return createLink(std::move(args), SET_LINK);
 	} else
 		// If none of the conditions apply just leave alone. Indeed,
 		// assuming that the pattern matcher is executing the rewrite
@@ -546,12 +560,11 @@ Handle AndBIT::mk_pattern(HandleSeq prs_clauses, HandleSeq virt_clauses) const
 	remove_redundant(virt_clauses);
 
 	// Assemble the body
-	AtomSpace& as = *fcs->getAtomSpace();
 	if (not prs_clauses.empty())
-		virt_clauses.push_back(as.add_link(PRESENT_LINK, std::move(prs_clauses)));
+		virt_clauses.push_back(createLink(std::move(prs_clauses), PRESENT_LINK));
 	return virt_clauses.empty() ? Handle::UNDEFINED
 		: (virt_clauses.size() == 1 ? virt_clauses.front()
-		   : as.add_link(AND_LINK, std::move(virt_clauses)));
+		   : createLink(std::move(virt_clauses), AND_LINK));
 }
 
 void AndBIT::remove_redundant(HandleSeq& hs)
@@ -728,6 +741,149 @@ std::string AndBIT::line_separator(const std::string& up_aa,
 	return std::string(lead_sp_size, ' ') + line_str;
 }
 
+////////////////
+// AndBITPool //
+////////////////
+
+AndBITPool::AndBITPool()
+	: _ordered_ids(IdLess(&_pool)),
+	  _weight([](const AndBIT& andbit) { return andbit.exhausted ? 0.0 : 1.0; })
+{}
+
+bool AndBITPool::empty() const
+{
+	return _ordered_ids.empty();
+}
+
+size_t AndBITPool::size() const
+{
+	return _ordered_ids.size();
+}
+
+AndBITPool::iterator AndBITPool::begin()
+{
+	return iterator(_ordered_ids.begin(), &_pool);
+}
+
+AndBITPool::iterator AndBITPool::end()
+{
+	return iterator(_ordered_ids.end(), &_pool);
+}
+
+AndBITPool::const_iterator AndBITPool::begin() const
+{
+	return const_iterator(_ordered_ids.begin(), &_pool);
+}
+
+AndBITPool::const_iterator AndBITPool::end() const
+{
+	return const_iterator(_ordered_ids.end(), &_pool);
+}
+
+AndBIT* AndBITPool::insert(AndBIT andbit)
+{
+	if (_fcs_index.find(andbit.fcs) != _fcs_index.end())
+		return nullptr;
+
+	// Recycle the place of an erased and-BIT if any
+	Id id;
+	if (_free_ids.empty()) {
+		id = _pool.size();
+		_pool.push_back(std::move(andbit));
+	} else {
+		id = _free_ids.back();
+		_free_ids.pop_back();
+		_pool[id] = std::move(andbit);
+	}
+
+	// The and-BIT must be in place before being indexed as the
+	// ordered index compares the and-BITs themselves.
+	_fcs_index.emplace(_pool[id].fcs, id);
+	_ordered_ids.insert(id);
+	_weights.set(id, _weight(_pool[id]));
+	return &_pool[id];
+}
+
+bool AndBITPool::erase(const Handle& fcs)
+{
+	auto it = _fcs_index.find(fcs);
+	if (it == _fcs_index.end())
+		return false;
+
+	Id id = it->second;
+	_fcs_index.erase(it);
+	_ordered_ids.erase(id);
+	_weights.set(id, 0.0);
+
+	// Release the and-BIT content and recycle its place
+	_pool[id] = AndBIT();
+	_free_ids.push_back(id);
+	return true;
+}
+
+AndBIT* AndBITPool::find(const Handle& fcs)
+{
+	auto it = _fcs_index.find(fcs);
+	return it == _fcs_index.end() ? nullptr : &_pool[it->second];
+}
+
+const AndBIT* AndBITPool::find(const Handle& fcs) const
+{
+	auto it = _fcs_index.find(fcs);
+	return it == _fcs_index.end() ? nullptr : &_pool[it->second];
+}
+
+AndBITPool::Id AndBITPool::id(const Handle& fcs) const
+{
+	return _fcs_index.at(fcs);
+}
+
+AndBIT& AndBITPool::operator[](Id id)
+{
+	return _pool[id];
+}
+
+const AndBIT& AndBITPool::operator[](Id id) const
+{
+	return _pool[id];
+}
+
+void AndBITPool::set_weight(const Weight& weight)
+{
+	_weight = weight;
+	reweight();
+}
+
+void AndBITPool::reweight(const AndBIT& andbit)
+{
+	Id i = id(andbit.fcs);
+	_weights.set(i, _weight(_pool[i]));
+}
+
+void AndBITPool::reweight()
+{
+	_weights.clear();
+	for (Id i : _ordered_ids)
+		_weights.set(i, _weight(_pool[i]));
+}
+
+double AndBITPool::weight(const AndBIT& andbit) const
+{
+	return _weights.get(id(andbit.fcs));
+}
+
+double AndBITPool::total_weight() const
+{
+	return _weights.total();
+}
+
+AndBIT* AndBITPool::sample(RandGen& rng)
+{
+	if (_weights.total() <= 0)
+		return nullptr;
+	return &_pool[_weights.sample(rng)];
+}
+
 /////////
 // BIT //
 /////////
@@ -756,13 +912,13 @@ size_t BIT::size() const
 
 AndBIT* BIT::init()
 {
-	andbits.emplace_back(bit_as, _init_target,
-	                     _init_vardecl, _init_fitness, _as);
+	AndBIT* andbit = andbits.insert(AndBIT(_init_target, _init_vardecl,
+	                                       _init_fitness, _as));
 
 	LAZY_URE_LOG_DEBUG << "Initialize BIT with:" << std::endl
-	                   << andbits.begin()->to_string();
+	                   << andbit->to_string();
 
-	return &*andbits.begin();
+	return andbit;
 }
 
 AndBIT* BIT::expand(AndBIT& andbit, BITNode& bitleaf,
@@ -786,23 +942,100 @@ AndBIT* BIT::expand(AndBIT& andbit, BITNode& bitleaf,
 
 AndBIT* BIT::insert(AndBIT& andbit)
 {
-	// Check that it isn't already in the BIT
-	if (boost::find(andbits, andbit) != andbits.end()) {
+	// Insert unless it is already in the BIT
+	AndBIT* inserted = andbits.insert(andbit);
+	if (not inserted) {
 		LAZY_URE_LOG_DEBUG << "The following and-BIT is already in the BIT: "
 		                   << andbit.fcs->id_to_string();
-		return nullptr;
 	}
-	// Insert while keeping the order
-	auto it = andbits.insert(boost::lower_bound(andbits, andbit), andbit);
+	return inserted;
+}
+
+bool BIT::insert_expansion(const Handle& fcs, const Handle& leaf,
+                           const RuleTypedSubstitutionPair& rule,
+                           AndBIT& new_andbit)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	AndBIT* andbit = find(fcs);
+	if (andbit == nullptr)
+		return false;
+	auto it = andbit->leaf2bitnode.find(leaf);
+	if (it == andbit->leaf2bitnode.end())
+		return false;
+	BITNode& bitleaf = it->second;
+
+	// Another thread may have expanded that BIT-node with an
+	// equivalent rule in the meantime.
+	if (is_in(rule, bitleaf)) {
+		ure_logger().debug() << "An equivalent rule has already expanded "
+		                     << "that BIT-node, abort expansion";
+		return false;
+	}
 
-	// Return andbit pointer
-	return &*it;
+	// Insert the rule as or-branch of this bitleaf
+	bitleaf.rules.insert(rule);
+
+	return (bool)new_andbit.fcs and insert(new_andbit) != nullptr;
+}
+
+void BIT::set_exhausted(const Handle& fcs, const Handle& leaf)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	AndBIT* andbit = find(fcs);
+	if (andbit == nullptr)
+		return;
+	auto it = andbit->leaf2bitnode.find(leaf);
+	if (it != andbit->leaf2bitnode.end())
+		it->second.exhausted = true;
+}
+
+Handle BIT::materialize(const Handle& fcs)
+{
+	return bit_as.add_atom(fcs);
+}
+
+void BIT::erase(const AndBIT& andbit)
+{
+	// Copy the FCS as andbit is released by the erasure
+	Handle fcs = andbit.fcs;
+	andbits.erase(fcs);
+	remove_materialized(fcs);
+}
+
+void BIT::set_exhausted(AndBIT& andbit)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	andbit.exhausted = true;
+	andbits.reweight(andbit);
+}
+
+void BIT::erase(const HandleSeq& fcss)
+{
+	for (const Handle& fcs : fcss)
+		andbits.erase(fcs);
+	for (const Handle& fcs : fcss)
+		remove_materialized(fcs);
+}
+
+void BIT::remove_materialized(const Handle& fcs)
+{
+	Handle mfcs = bit_as.get_atom(fcs);
+	if (mfcs)
+		remove_hypergraph(bit_as, mfcs);
+}
+
+AndBIT* BIT::find(const Handle& fcs)
+{
+	return andbits.find(fcs);
 }
 
 void BIT::reset_exhausted_flags()
 {
 	for (AndBIT& andbit : andbits)
 		andbit.reset_exhausted();
+	andbits.reweight();
 }
 
 bool BIT::andbits_exhausted() const
@@ -817,6 +1050,147 @@ bool BIT::is_in(const RuleTypedSubstitutionPair& rule,
 	return bitnode.rules.find(rule.first) != bitnode.rules.end();
 }
 
+void BIT::save(RuleBaseWriter& writer) const
+{
+	writer.put_atom(_init_target);
+	writer.put_bool((bool)_init_vardecl);
+	if (_init_vardecl)
+		writer.put_atom(_init_vardecl);
+
+	LeafStamps stamps;
+	writer.put_uint(andbits.size());
+	for (const AndBIT& andbit : andbits) {
+		Handle vardecl = BindLinkCast(andbit.fcs)->get_vardecl();
+		writer.put_atom(andbit.fcs);
+		writer.put_double(andbit.complexity);
+		writer.put_bool(andbit.exhausted);
+		writer.put_uint(andbit.leaf2bitnode.size());
+		for (const auto& lb : andbit.leaf2bitnode) {
+			const BITNode& bitnode = lb.second;
+			writer.put_atom(lb.first);
+			writer.put_double(bitnode.complexity);
+			writer.put_bool(bitnode.exhausted);
+			writer.put_uint(leaf_stamp(lb.first, vardecl, stamps));
+			writer.put_uint(bitnode.rules.size());
+			for (const auto& rule : bitnode.rules) {
+				writer.put_atom(rule.first.get_alias());
+				writer.put_atom(rule.first.get_rule());
+			}
+		}
+	}
+}
+
+HandleSeq BIT::load(RuleBaseReader& reader, const RuleSet& rules)
+{
+	Handle target = reader.get_atom();
+	Handle vardecl = reader.get_bool() ? reader.get_atom() : Handle::UNDEFINED;
+	if (not content_eq(target, _init_target) or
+	    not content_eq(vardecl, _init_vardecl))
+		throw RuntimeException(TRACE_INFO,
+			"BIT - the snapshot is of another target: %s",
+			oc_to_string(target).c_str());
+
+	HandleSeq fcss;
+	size_t reset = 0;
+	LeafStamps stamps;
+	uint32_t andbit_count = reader.get_uint();
+	for (uint32_t i = 0; i < andbit_count; i++) {
+		Handle fcs = reader.get_atom();
+		Handle vardecl = BindLinkCast(fcs)->get_vardecl();
+		double complexity = reader.get_double();
+		AndBIT andbit(fcs, complexity, _as);
+		andbit.exhausted = reader.get_bool();
+
+		bool changed = false;
+		uint32_t leaf_count = reader.get_uint();
+		for (uint32_t j = 0; j < leaf_count; j++) {
+			Handle leaf = reader.get_atom();
+			auto it = andbit.leaf2bitnode.find(leaf);
+			if (it == andbit.leaf2bitnode.end())
+				it = andbit.leaf2bitnode.emplace(leaf, BITNode(leaf)).first;
+			BITNode& bitnode = it->second;
+			if (content_eq(leaf, _init_target))
+				bitnode.fitness = _init_fitness;
+			bitnode.complexity = reader.get_double();
+			bitnode.exhausted = reader.get_bool();
+
+			// Atoms that may fulfill the leaf have been added,
+			// removed or modified since the snapshot
+			if (reader.get_uint() != leaf_stamp(leaf, vardecl, stamps))
+				changed = true;
+
+			uint32_t rule_count = reader.get_uint();
+			for (uint32_t k = 0; k < rule_count; k++) {
+				Handle alias = reader.get_atom();
+				Handle rule_h = reader.get_atom();
+				auto base = std::find_if(rules.begin(), rules.end(),
+				                         [&](const RulePtr& r) {
+					                         return r->get_name() == alias->get_name(); });
+				if (base == rules.end())
+					throw RuntimeException(TRACE_INFO,
+						"BIT - the rule %s of the snapshot is not in the "
+						"rule base", alias->get_name().c_str());
+
+				Rule rule(**base);
+				rule.set_rule(rule_h);
+				bitnode.rules.emplace(rule, Unify::TypedSubstitution());
+			}
+		}
+
+		// The whole and-BIT may now be fulfilled or expanded
+		// differently, thus all its BIT-nodes are reset.
+		if (changed) {
+			andbit.reset_exhausted();
+			reset += leaf_count;
+		}
+
+		if (andbits.insert(std::move(andbit)))
+			fcss.push_back(fcs);
+	}
+
+	ure_logger().debug() << "Loaded " << fcss.size() << " and-BITs, "
+	                     << reset << " BIT-nodes have been reset";
+	return fcss;
+}
+
+uint32_t BIT::leaf_stamp(const Handle& leaf, const Handle& vardecl,
+                         LeafStamps& stamps) const
+{
+	// Only the declarations of the variables of the leaf matter
+	Handle leaf_vardecl = vardecl ? filter_vardecl(vardecl, leaf)
+		: Handle::UNDEFINED;
+	Handle key = leaf_vardecl ? createLink(LIST_LINK, leaf, leaf_vardecl)
+		: createLink(LIST_LINK, leaf);
+	auto it = stamps.find(key);
+	if (it != stamps.end())
+		return it->second;
+
+	// Candidates are the atoms of the type of the leaf, or all atoms
+	// if it is a variable, among which only those unifying with the
+	// leaf may fulfill it. The atoms are not ordered, thus their
+	// hashes are summed.
+	Type type = leaf->get_type() == VARIABLE_NODE ? ATOM : leaf->get_type();
+	HandleSeq hs;
+	_as->get_handles_by_type(hs, type, true);
+	size_t seed = 0, count = 0;
+	for (const Handle& h : hs) {
+		if (not unifiable(leaf, h, leaf_vardecl))
+			continue;
+		size_t h_seed = h->get_hash();
+		TruthValuePtr tv = h->getTruthValue();
+		boost::hash_combine(h_seed, tv->get_mean());
+		boost::hash_combine(h_seed, tv->get_confidence());
+		seed += h_seed;
+		count++;
+	}
+	boost::hash_combine(seed, count);
+
+	// Fold it to fit in a snapshot
+	uint32_t stamp = seed ^ (uint64_t(seed) >> 32);
+	stamps.emplace(key, stamp);
+	return stamp;
+}
+
 std::string oc_to_string(const BITNode& bitnode, const std::string& indent)
 {
 	return bitnode.to_string(indent);
@@ -23,17 +23,35 @@
 #ifndef _OPENCOG_BIT_H
 #define _OPENCOG_BIT_H
 
+#include <mutex>
+#include <deque>
+#include <functional>
+#include <set>
+
 #include <boost/operators.hpp>
+#include <boost/iterator/iterator_adaptor.hpp>
 
 #include <opencog/util/empty_string.h>
 #include <opencog/ure/Rule.h>
+#include <opencog/ure/RuleBaseFile.h>
 #include <opencog/atoms/base/Handle.h>
 #include <opencog/atomspaceutils/AtomSpaceUtils.h>
+#include "../SumTree.h"
 #include "Fitness.h"
 
 namespace opencog
 {
 
+// Compare handles by content. FCSs are built outside of any
+// atomspace, thus equivalent FCSs, or leaves, are not necessarily the
+// same atoms.
+struct content_eq_handle
+{
+	bool operator()(const Handle& lhs, const Handle& rhs) const {
+		return content_eq(lhs, rhs);
+	}
+};
+
 /**
  * A BIT (Back Inference Tree) node, and how it relates to its
  * children. A back-inference tree is an and-or-tree, where there are
@@ -79,11 +97,16 @@ public:
 class AndBIT : public boost::totally_ordered<AndBIT>
 {
 public:
-	// FCS associated to the and-BIT
+	// FCS associated to the and-BIT. It does not belong to any
+	// atomspace, sharing its unchanged sub-terms with the FCS of the
+	// parent and-BIT, till it gets materialized in bit_as, see
+	// BIT::materialize.
 	Handle fcs;
 
 	// Mapping from the FCS leaves to BITNodes
-	typedef std::unordered_map<Handle, BITNode> HandleBITNodeMap;
+	typedef std::unordered_map<Handle, BITNode,
+	                           std::hash<Handle>,
+	                           content_eq_handle> HandleBITNodeMap;
 	HandleBITNodeMap leaf2bitnode;
 
 	// The complexity of an and-BIT is the sum of the complexities of
@@ -100,13 +123,13 @@ public:
 
 	/**
 	 * @brief Initialize an and-BIT with a certain target, vardecl and
-	 * fitness and add it in bit_as. If an extra atomspace queried_as
+	 * fitness. If an extra atomspace queried_as
 	 * is provided, then subsequent and-BITs produced from it will
 	 * have their constants removed if present in the queried
 	 * atomspace.
 	 */
 	AndBIT();
-	AndBIT(AtomSpace& bit_as, const Handle& target, Handle vardecl,
+	AndBIT(const Handle& target, Handle vardecl,
 	       const BITNodeFitness& fitness=BITNodeFitness(),
 	       const AtomSpace* queried_as=nullptr);
 	/**
@@ -114,8 +137,13 @@ public:
 	 */
 	AndBIT(const Handle& fcs, double complexity=0.0,
 	       const AtomSpace* queried_as=nullptr);
+	AndBIT(const AndBIT&) = default;
+	AndBIT(AndBIT&&) = default;
 	~AndBIT();
 
+	AndBIT& operator=(const AndBIT&) = default;
+	AndBIT& operator=(AndBIT&&) = default;
+
 	/**
 	 * @brief Expand the and-BIT given a target leaf and rule.
 	 *
@@ -138,7 +166,14 @@ public:
 	 *
 	 * @return The selected leaf.
 	 */
-	BITNode* select_leaf();
+	BITNode* select_leaf(RandGen& rng=randGen());
+
+	/**
+	 * Return a copy of this and-BIT holding only the BIT-node of the
+	 * given leaf, which is all that is needed to select a rule for
+	 * that leaf and expand it, without copying all its BIT-nodes.
+	 */
+	AndBIT leaf_copy(const Handle& leaf) const;
 
 	/**
 	 * Set the and-BIT exhausted flags to false. Take care of the
@@ -165,7 +200,8 @@ public:
 	 * present in the same branch path, so is [14389148767193402296][1].
 	 */
 	bool has_cycle() const;
-	bool has_cycle(const Handle& h, HandleSet ancestors = {}) const;
+	typedef std::set<Handle, content_based_handle_less> Ancestors;
+	bool has_cycle(const Handle& h, Ancestors ancestors = {}) const;
 
 	/**
 	 * Comparison operators. For operator< compare fcs by complexity, or by
@@ -405,6 +441,175 @@ private:
 	                                  bool unordered_premises=false);
 };
 
+/**
+ * Collection of and-BITs.
+ *
+ * And-BITs are stored in a pool (a deque) so that pointers and
+ * references to them remain valid as other and-BITs are inserted or
+ * erased. Each and-BIT is identified by its position in the pool, and
+ * the positions of erased and-BITs are recycled by subsequent
+ * insertions.
+ *
+ * Two indices are maintained over the pool
+ *
+ * 1. a hash index from FCS to ID, to detect duplicates in constant
+ *    time. FCSs do not belong to any atomspace, unless materialized,
+ *    thus and-BITs with the same content may have distinct handles,
+ *    and are hashed and compared by content instead.
+ *
+ * 2. an ordered index of IDs, by complexity then by content (see
+ *    AndBIT::operator<), to iterate over the and-BITs from the
+ *    simplest to the most complex.
+ *
+ * Insertion and erasure are in O(log n), duplicate lookup in O(1).
+ *
+ * Additionally each and-BIT has a weight, maintained in a sum tree
+ * indexed by ID, so that an and-BIT can be sampled according to its
+ * weight in O(log n). The weight of an and-BIT is calculated once at
+ * insertion, then whenever reweight is called, which must be done
+ * after any change affecting it, such as its exhausted flag.
+ */
+class AndBITPool
+{
+public:
+	typedef size_t Id;
+
+private:
+	typedef std::deque<AndBIT> Storage;
+
+	// Order IDs according to the and-BITs they refer to
+	struct IdLess
+	{
+		IdLess(const Storage* pool) : _pool(pool) {}
+		bool operator()(Id lhs, Id rhs) const {
+			return (*_pool)[lhs] < (*_pool)[rhs];
+		}
+		const Storage* _pool;
+	};
+	typedef std::set<Id, IdLess> IdIndex;
+
+	// Iterate over the ordered index and dereference to and-BITs
+	template<typename Value, typename StoragePtr>
+	class Iterator
+		: public boost::iterator_adaptor<Iterator<Value, StoragePtr>,
+		                                 IdIndex::const_iterator, Value>
+	{
+	public:
+		Iterator() : _pool(nullptr) {}
+		Iterator(IdIndex::const_iterator it, StoragePtr pool)
+			: Iterator::iterator_adaptor_(it), _pool(pool) {}
+
+		Id id() const { return *this->base(); }
+
+	private:
+		friend class boost::iterator_core_access;
+		Value& dereference() const { return (*_pool)[*this->base()]; }
+
+		StoragePtr _pool;
+	};
+
+public:
+	typedef AndBIT value_type;
+	typedef std::function<double(const AndBIT&)> Weight;
+	typedef Iterator<AndBIT, Storage*> iterator;
+	typedef Iterator<const AndBIT, const Storage*> const_iterator;
+
+	AndBITPool();
+	AndBITPool(const AndBITPool&) = delete;
+	AndBITPool& operator=(const AndBITPool&) = delete;
+
+	bool empty() const;
+	size_t size() const;
+
+	/**
+	 * Iterate over the and-BITs from the simplest to the most
+	 * complex.
+	 */
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	/**
+	 * Insert an and-BIT, return a pointer to it, or nullptr if an
+	 * and-BIT with the same FCS is already in.
+	 */
+	AndBIT* insert(AndBIT andbit);
+
+	/**
+	 * Erase the and-BIT of the given FCS. Return true if erased.
+	 */
+	bool erase(const Handle& fcs);
+
+	/**
+	 * Return the and-BIT with the given FCS, nullptr if none.
+	 */
+	AndBIT* find(const Handle& fcs);
+	const AndBIT* find(const Handle& fcs) const;
+
+	/**
+	 * Return the ID of the and-BIT of the given FCS. Assume it is in
+	 * the pool.
+	 */
+	Id id(const Handle& fcs) const;
+
+	/**
+	 * Return the and-BIT of the given ID. Assume it is in the pool.
+	 */
+	AndBIT& operator[](Id id);
+	const AndBIT& operator[](Id id) const;
+
+	/**
+	 * Set the weight function and recalculate all weights. By
+	 * default the weight is 0 if the and-BIT is exhausted, 1
+	 * otherwise.
+	 */
+	void set_weight(const Weight& weight);
+
+	/**
+	 * Recalculate the weight of the given and-BIT, or of all and-BITs.
+	 */
+	void reweight(const AndBIT& andbit);
+	void reweight();
+
+	/**
+	 * Return the weight of the given and-BIT, as last calculated.
+	 */
+	double weight(const AndBIT& andbit) const;
+
+	/**
+	 * Return the sum of the weights of all and-BITs.
+	 */
+	double total_weight() const;
+
+	/**
+	 * Sample an and-BIT according to its weight, in O(log n). Return
+	 * nullptr if all weights are null.
+	 */
+	AndBIT* sample(RandGen& rng=randGen());
+
+private:
+	// And-BITs, including erased ones (with undefined FCS)
+	Storage _pool;
+
+	// IDs of erased and-BITs, to be recycled
+	std::vector<Id> _free_ids;
+
+	// FCS to ID index, by content
+	std::unordered_map<Handle, Id, std::hash<Handle>,
+	                   content_eq_handle> _fcs_index;
+
+	// IDs ordered by complexity then content
+	IdIndex _ordered_ids;
+
+	// Calculate the weight of an and-BIT
+	Weight _weight;
+
+	// Weights of the and-BITs indexed by ID, erased ones have null
+	// weights.
+	SumTree _weights;
+};
+
 /**
  * Back Inference Tree. A graph of BIT-Nodes and a collection of
  * and-BITs (as Forward Chaining Strategies, FCS for short), with
@@ -413,14 +618,13 @@ private:
 class BIT
 {
 public:
-	// Child atomspace of the queried atomspace for storing the BIT
+	// Child atomspace of the queried atomspace for storing the FCSs
+	// selected for fulfillment
 	AtomSpace bit_as;
 
-	// Collection of and-BITs. We use a sorted vector instead of a set
-	// because the andbit being expanded is modified (its expanded
-	// bit-Node keeps track of the expansion). Alternatively we could
-	// use a set and define AndBIT::leaf2bitnode as mutable.
-	typedef std::vector<AndBIT> AndBITs;
+	// Collection of and-BITs, ordered by complexity. Pointers to
+	// and-BITs remain valid until they are erased, see AndBITPool.
+	typedef AndBITPool AndBITs;
 	AndBITs andbits;
 
 	/**
@@ -461,16 +665,60 @@ public:
 	/**
 	 * Insert a new andbit in the BIT and return its pointer, nullptr
 	 * if not inserted (which may happen if an equivalent one is
-	 * already in it). Warning: the reference on andbit will likely be
-	 * invalid after this call because the container is modified.
+	 * already in it).
 	 */
 	AndBIT* insert(AndBIT& andbit);
 
+	/**
+	 * Insert an expansion that has been calculated, possibly by
+	 * another thread, over a copy of an and-BIT of this BIT. The
+	 * original and-BIT and BIT-node are retrieved by FCS and leaf,
+	 * then the rule is recorded as or-child of that BIT-node and
+	 * new_andbit is inserted, all under the BIT lock so that
+	 * concurrent expansions do not step over each other.
+	 *
+	 * Return true iff new_andbit has been inserted.
+	 */
+	bool insert_expansion(const Handle& fcs, const Handle& leaf,
+	                      const RuleTypedSubstitutionPair& rule,
+	                      AndBIT& new_andbit);
+
+	/**
+	 * Set the exhausted flag of the BIT-node of leaf, in the and-BIT
+	 * of the given FCS, under the BIT lock.
+	 */
+	void set_exhausted(const Handle& fcs, const Handle& leaf);
+
+	/**
+	 * Set the exhausted flag of the given and-BIT, and update its
+	 * weight accordingly.
+	 */
+	void set_exhausted(AndBIT& andbit);
+
+	/**
+	 * Return the and-BIT with the given FCS, nullptr if there is none.
+	 */
+	AndBIT* find(const Handle& fcs);
+
+	/**
+	 * Add fcs to bit_as, if not already, and return it. And-BITs
+	 * keep their FCSs outside of bit_as, as most of them are never
+	 * fulfilled, so this is only done for the FCSs selected for
+	 * fulfillment.
+	 */
+	Handle materialize(const Handle& fcs);
+
 	/**
 	 * Erase the given and-BIT from the BIT and remove its FCS from
-	 * bit_as.
+	 * bit_as, if it was materialized.
+	 */
+	void erase(const AndBIT& andbit);
+
+	/**
+	 * Erase the and-BITs of the given FCSs from the BIT, then remove
+	 * their materialized FCSs from bit_as.
 	 */
-	template<typename It> AndBITs::iterator erase(It pos);
+	void erase(const HandleSeq& fcss);
 
 	/**
 	 * Reset to false all and-BITs exhausted flags.
@@ -489,21 +737,57 @@ public:
 	bool is_in(const RuleTypedSubstitutionPair& rule,
 	           const BITNode& bitnode) const;
 
+	/**
+	 * Write the and-BITs to a snapshot, see
+	 * BackwardChainer::save_snapshot. That is their FCSs, complexities
+	 * and exhausted flags, and for each of their BIT-nodes, its
+	 * complexity, exhausted flag, tried rules and a stamp of the
+	 * atoms that may fulfill its leaf in the queried atomspace, see
+	 * leaf_stamp.
+	 */
+	void save(RuleBaseWriter& writer) const;
+
+	/**
+	 * Insert the and-BITs read from a snapshot. Tried rules are
+	 * rebuilt from the rules of the same name in rules, without their
+	 * typed substitutions as only their presence matters, see is_in.
+	 *
+	 * And-BITs with a leaf whose stamp has changed since the
+	 * snapshot, that is atoms that may fulfill it have been added,
+	 * removed or had their TVs modified in the queried atomspace, are
+	 * reset to unexhausted, as well as all their BIT-nodes.
+	 *
+	 * Throw a RuntimeException if the snapshot is of another target,
+	 * or a tried rule is missing.
+	 *
+	 * @return the FCSs of the inserted and-BITs.
+	 */
+	HandleSeq load(RuleBaseReader& reader, const RuleSet& rules);
+
 private:
+	// Remove the materialized version of fcs from bit_as, if any
+	void remove_materialized(const Handle& fcs);
+
+	// Return a stamp of the atoms of the queried atomspace that may
+	// fulfill leaf, that is a hash of the atoms unifying with it,
+	// given the variable declaration vardecl of its and-BIT, with
+	// their TVs, like RuleBaseCache::stamp. Stamps are memoized by
+	// leaf and variable declaration in stamps.
+	typedef std::map<Handle, uint32_t, content_based_handle_less> LeafStamps;
+	uint32_t leaf_stamp(const Handle& leaf, const Handle& vardecl,
+	                    LeafStamps& stamps) const;
+
 	// Queried atomspace
 	AtomSpace* _as;
 
 	Handle _init_target;
 	Handle _init_vardecl;
 	BITNodeFitness _init_fitness;
-};
 
-template<typename It>
-BIT::AndBITs::iterator BIT::erase(It pos)
-{
-	remove_hypergraph(bit_as, pos->fcs);
-	return andbits.erase(pos);
-}
+	// Protect andbits and their BIT-nodes during concurrent
+	// expansions
+	std::mutex _mutex;
+};
 
 // Gdb debugging, see
 // http://wiki.opencog.org/w/Development_standards#Print_OpenCog_Objects
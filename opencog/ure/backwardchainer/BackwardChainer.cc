@@ -23,12 +23,21 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <set>
+
+#include <opencog/util/mt19937ar.h>
 #include <opencog/util/random.h>
 
 #include <opencog/unify/Unify.h>
+#include <opencog/atoms/pattern/BindLink.h>
 
 #include "BackwardChainer.h"
 #include "../URELogger.h"
+#include "../RuleBaseCache.h"
 
 using namespace opencog;
 
@@ -44,19 +53,47 @@ BackwardChainer::BackwardChainer(AtomSpace& kb_as,
                                                           // focus_set
                                  const BITNodeFitness& bitnode_fitness,
                                  const AndBITFitness& andbit_fitness)
+	: BackwardChainer(kb_as, *RuleBaseCache::instance().get(rb_as, rbs),
+	                  target, vardecl, trace_as, control_as, nullptr,
+	                  bitnode_fitness, andbit_fitness)
+{
+}
+
+BackwardChainer::BackwardChainer(AtomSpace& kb_as,
+                                 const UREConfig& config,
+                                 const Handle& target,
+                                 const Handle& vardecl,
+                                 AtomSpace* trace_as,
+                                 AtomSpace* control_as,
+                                 const ExpansionControlRulesPtr& exp_ctrl_rules,
+                                 const BITNodeFitness& bitnode_fitness,
+                                 const AndBITFitness& andbit_fitness)
 	: _kb_as(kb_as),
-	  _rb_as(rb_as),
-	  _config(_rb_as, rbs),
+	  _snapshot_as(&kb_as),
+	  _config(config),
+	  _budget(_config, kb_as),
 	  _bit(kb_as, target, vardecl, bitnode_fitness),
 	  _andbit_fitness(andbit_fitness),
 	  _trace_recorder(trace_as),
-	  _control(_config, _bit, target, control_as),
+	  _control(_config, _bit, target, control_as, exp_ctrl_rules),
 	  _rules(_control.rules),
 	  _iteration(0),
-	  _last_expansion_andbit(nullptr)
+	  _cancellation(std::make_shared<CancellationToken>()),
+	  _rng(&randGen()),
+	  _started(false),
+	  _finished(false),
+	  _kb_updates(0),
+	  _fulfillment([this](const Handle& fcs) { return execute_fcs(fcs); })
 {
 	// Record the target in the trace atomspace
 	_trace_recorder.target(target);
+
+	// Maintain the expansion weights of the and-BITs as they are
+	// inserted, see select_expansion_andbit()
+	_bit.andbits.set_weight([this](const AndBIT& andbit) {
+			return operator()(andbit); });
+
+	_control.set_cancellation_token(_cancellation);
 }
 
 BackwardChainer::BackwardChainer(AtomSpace& kb_as,
@@ -87,16 +124,190 @@ const UREConfig& BackwardChainer::get_config() const
 
 void BackwardChainer::do_chain()
 {
-	ure_logger().debug("Start backward chaining");
-	LAZY_URE_LOG_DEBUG << "With rule set:" << std::endl << oc_to_string(_rules);
+	run(-1);
+}
+
+bool BackwardChainer::run(int max_steps, int max_ms)
+{
+	if (_finished)
+		return true;
+
+	if (not _started)
+		start_chain();
+	else {
+		ure_logger().debug() << "Resume backward chaining at iteration "
+		                     << _iteration;
+
+		// The subgoals may have new proofs, or lost some
+		if (_config.get_goal_tabling() and
+		    not (kb_version() == _suspension_version)) {
+			ure_logger().debug() << "The knowledge base has changed, "
+			                     << "reset the goal table";
+			reset_goal_table();
+		}
+	}
 
-	while (not termination())
+	// The fulfillment cache holds no more entries than the BIT holds
+	// and-BITs, if bounded
+	int max_bit_size = _config.get_max_bit_size();
+	_fulfillment_cache.set_capacity(std::max(max_bit_size, 0));
+
+	// Launch the fulfillment workers, if any
+	if (0 < _config.get_fulfillment_jobs())
+		_fulfillment.start(_config.get_fulfillment_jobs(),
+		                   _config.get_fulfillment_queue_size());
+
+	// Launch the expansion workers, the chaining thread being one of
+	// them, if multithreaded
+	if (1 < _config.get_jobs())
+		_expansion_workers.start(_config.get_jobs() - 1);
+
+	// Set log thread ID if multi-threaded
+	bool prev_thread_id = ure_logger().get_thread_id_flag();
+	if (1 < _config.get_jobs() or _fulfillment.is_started())
+		ure_logger().set_thread_id_flag(true);
+
+	_budget.start_slice(_iteration, max_steps, max_ms);
+
+	bool terminated = termination();
+	while (not terminated and not _budget.slice_exceeded(_iteration))
 	{
 		do_step();
+		terminated = termination();
 	}
 
+	// Wait for the pending fulfillments and record their results
+	_fulfillment.stop();
+	collect_fulfillments();
+	_expansion_workers.stop();
+
+	_budget.end_slice();
+
+	// Restore logging thread ID flag
+	ure_logger().set_thread_id_flag(prev_thread_id);
+
+	if (not terminated) {
+		ure_logger().debug() << "Suspend backward chaining at iteration "
+		                     << _iteration;
+		_suspension_version = kb_version();
+		return false;
+	}
+
+	finish_chain();
+	return true;
+}
+
+bool BackwardChainer::is_finished() const
+{
+	return _finished;
+}
+
+void BackwardChainer::save_snapshot(const std::string& filename) const
+{
+	RuleBaseWriter writer(bit_snapshot_magic);
+	writer.put_atom(_config.get_rbs());
+	_config.save_rule_bodies(writer);
+	_bit.save(writer);
+
+	std::string tmp = filename + ".tmp";
+	writer.write(tmp);
+	if (std::rename(tmp.c_str(), filename.c_str()) != 0)
+		throw RuntimeException(TRACE_INFO,
+			"BackwardChainer - cannot rename %s to %s",
+			tmp.c_str(), filename.c_str());
+
+	ure_logger().debug() << "Saved BIT snapshot of " << _bit.size()
+	                     << " and-BITs to " << filename;
+}
+
+void BackwardChainer::load_snapshot(const std::string& filename)
+{
+	if (_started)
+		throw RuntimeException(TRACE_INFO,
+			"BackwardChainer - cannot load a snapshot once chaining "
+			"has started");
+
+	// FCSs and specialized rules are loaded in the snapshot atomspace
+	// so that they do not pollute the knowledge base.
+	RuleBaseReader reader(_snapshot_as, filename, bit_snapshot_magic);
+
+	Handle rbs = reader.get_atom();
+	if (rbs->get_name() != _config.get_rbs()->get_name())
+		throw RuntimeException(TRACE_INFO,
+			"BackwardChainer - snapshot %s is of rule base %s, not %s",
+			filename.c_str(), rbs->get_name().c_str(),
+			_config.get_rbs()->get_name().c_str());
+	if (not _config.same_rule_bodies(reader))
+		throw RuntimeException(TRACE_INFO,
+			"BackwardChainer - snapshot %s is of other rules than "
+			"those of rule base %s", filename.c_str(),
+			rbs->get_name().c_str());
+
+	// Meta rules may have expanded the snapshot BIT
+	expand_meta_rules();
+
+	HandleSeq fcss = _bit.load(reader, _rules);
+	_snapshot_fcss.insert(_snapshot_fcss.end(), fcss.begin(), fcss.end());
+
+	// The knowledge base may have changed since the snapshot, and the
+	// loaded and-BITs have no recorded expansions anyway
+	reset_goal_table();
+}
+
+void BackwardChainer::start_chain()
+{
+	ure_logger().debug("Start backward chaining");
+	LAZY_URE_LOG_DEBUG << "With rule set:" << std::endl << oc_to_string(_rules);
+
+	// Budgets are measured from the start of chaining
+	_budget.start();
+
+	// The complexity penalty may have changed since construction
+	_bit.andbits.reweight();
+
+	_trace_recorder.set_sampling(_config.get_trace_sampling());
+	_trace_recorder.set_async(_config.get_trace_async());
+
+	_started = true;
+}
+
+void BackwardChainer::finish_chain()
+{
+	_control.forget_activities();
+	_expansion_rules.clear();
+	_tabled_expansions.clear();
+	_untabled_fcss.clear();
+	_tabled_feeds.clear();
+
+	if (_config.get_fulfillment_cache())
+		LAZY_URE_LOG_DEBUG << "Fulfillment cache: " << _fulfillment_cache.hits()
+		                   << " hits, " << _fulfillment_cache.misses()
+		                   << " misses, " << _fulfillment_cache.size()
+		                   << " entries";
+	if (_config.get_goal_tabling())
+		LAZY_URE_LOG_DEBUG << "Goal table: " << _goal_table.size()
+		                   << " subgoals, " << _goal_table.hits()
+		                   << " hits, " << _goal_table.misses() << " misses";
+	LAZY_URE_LOG_DEBUG << "Valid rules cache: " << _control.valid_rules_hits()
+	                   << " hits, " << _control.valid_rules_misses()
+	                   << " misses, hit rate " << _control.valid_rules_hit_rate();
+
 	LAZY_URE_LOG_DEBUG << "Finished backward chaining with results:"
 	                   << std::endl << oc_to_string(get_results_set());
+
+	// Write the learned rule TVs back to the rule base
+	if (_config.get_rule_tv_persistence()) {
+		_rules.save_tvs();
+		ure_logger().debug() << "Rule TVs have been saved to the rule base";
+	}
+
+	// Make sure the trace atomspace is complete
+	_trace_recorder.flush();
+
+	// Let the consumers know that no more results are coming
+	_result_stream.close();
+
+	_finished = true;
 }
 
 void BackwardChainer::do_step()
@@ -116,14 +327,22 @@ bool BackwardChainer::termination()
 	bool terminate = false;
 	std::string msg;            // Cause of the termination
 
-	if (_config.get_maximum_iterations() == _iteration) {
+	if (is_cancelled()) {
+		msg = "cancelled";
+		terminate = true;
+	}
+	else if (_config.get_maximum_iterations() == _iteration) {
 		msg = "reached the maximum number of iterations";
 		terminate = true;
 	}
-	else if (not _bit.empty() and _bit.andbits_exhausted()) {
+	else if (not _bit.empty() and _bit.andbits_exhausted() and
+	         _snapshot_fcss.empty()) {
 		msg = "all AndBITS are exhausted";
 		terminate = true;
 	}
+	else if (_budget.exceeded(msg)) {
+		terminate = true;
+	}
 
 	if (terminate)
 		ure_logger().debug() << "Terminate: " << msg;
@@ -131,6 +350,37 @@ bool BackwardChainer::termination()
 	return terminate;
 }
 
+void BackwardChainer::cancel()
+{
+	_cancellation->cancel();
+}
+
+bool BackwardChainer::is_cancelled() const
+{
+	return _cancellation->is_cancelled();
+}
+
+void BackwardChainer::set_cancellation_token(const CancellationTokenPtr& token)
+{
+	_cancellation = token;
+	_control.set_cancellation_token(token);
+}
+
+const CancellationTokenPtr& BackwardChainer::get_cancellation_token() const
+{
+	return _cancellation;
+}
+
+void BackwardChainer::set_random_generator(RandGen& rng)
+{
+	_rng = &rng;
+}
+
+int BackwardChainer::get_iteration() const
+{
+	return _iteration;
+}
+
 Handle BackwardChainer::get_results() const
 {
 	HandleSeq results(_results.begin(), _results.end());
@@ -142,6 +392,11 @@ const HandleSet& BackwardChainer::get_results_set() const
 	return _results;
 }
 
+ResultStream& BackwardChainer::get_result_stream()
+{
+	return _result_stream;
+}
+
 void BackwardChainer::expand_meta_rules()
 {
 	// This is kinda of hack before meta rules are fully supported by
@@ -153,6 +408,7 @@ void BackwardChainer::expand_meta_rules()
 	// flags.
 	if (rules_size != _rules.size()) {
 		_bit.reset_exhausted_flags();
+		reset_goal_table();
 		ure_logger().debug() << "The rule set has gone from "
 		                     << rules_size << " rules to " << _rules.size()
 		                     << ". All exhausted flags have been reset.";
@@ -164,13 +420,16 @@ void BackwardChainer::expand_bit()
 	// Expand meta rules, before they are fully supported
 	expand_meta_rules();
 
-	// Reset _last_expansion_fcs
-	_last_expansion_andbit = nullptr;
+	// Reset _last_expansion_fcss
+	_last_expansion_fcss.clear();
 
 	if (_bit.empty()) {
-		_last_expansion_andbit = _bit.init();
+		AndBIT* andbit = _bit.init();
+		_last_expansion_fcss.push_back(andbit->fcs);
 		// Record the initial and-BIT in the trace atomspace
-		_trace_recorder.andbit(*_last_expansion_andbit);
+		_trace_recorder.andbit(*andbit);
+	} else if (1 < _config.get_jobs()) {
+		expand_bit_multithread();
 	} else {
 		// Select an FCS (i.e. and-BIT) and expand it
 		AndBIT* andbit = select_expansion_andbit();
@@ -178,27 +437,153 @@ void BackwardChainer::expand_bit()
 		                   << andbit->to_string();
 		expand_bit(*andbit);
 	}
+
+	// Share the expansions of the subgoals with the new and-BITs,
+	// including the ones produced by the replays of the previous
+	// iteration.
+	if (_config.get_goal_tabling()) {
+		feed_tabled_consumers();
+		HandleSeq fcss(std::move(_untabled_fcss));
+		_untabled_fcss.clear();
+		fcss.insert(fcss.end(), _last_expansion_fcss.begin(),
+		            _last_expansion_fcss.end());
+		table_andbits(fcss);
+	}
 }
 
 void BackwardChainer::expand_bit(AndBIT& andbit)
 {
 	// Select leaf
-	BITNode* bitleaf = andbit.select_leaf();
+	BITNode* bitleaf = andbit.select_leaf(*_rng);
 	if (bitleaf) {
 		LAZY_URE_LOG_DEBUG << "Selected BIT-node for expansion:" << std::endl
 		                   << bitleaf->to_string();
 	} else {
 		ure_logger().debug() << "All BIT-nodes of this and-BIT are exhausted "
 		                     << "(or possibly fulfilled). Abort expansion.";
-		andbit.exhausted = true;
+		_bit.set_exhausted(andbit);
 		return;
 	}
 
 	// Select rule for expansion
-	RuleSelection rule_sel = _control.select_rule(andbit, *bitleaf);
-	Rule rule(rule_sel.first.first);
-	Unify::TypedSubstitution ts(rule_sel.first.second);
-	double prob(rule_sel.second);
+	Rule rule;
+	Unify::TypedSubstitution ts;
+	double prob;
+	if (not select_expansion_rule(andbit, *bitleaf, *_rng, rule, ts, prob)) {
+		if (bitleaf->exhausted)
+			record_tabled_completion(andbit, bitleaf->body);
+		return;
+	}
+
+	// Expand andbit
+	RuleTypedSubstitutionPair rtsp{rule, ts};
+	const AndBIT* new_andbit = _bit.expand(andbit, *bitleaf, rtsp, prob);
+
+	// Record the expansion in the trace atomspace
+	if (new_andbit) {
+		_last_expansion_fcss.push_back(new_andbit->fcs);
+		record_expansion_rule(new_andbit->fcs, rule);
+		record_tabled_expansion(andbit, bitleaf->body, rule, new_andbit->fcs);
+		_trace_recorder.andbit(*new_andbit);
+		_trace_recorder.expansion(andbit.fcs, bitleaf->body,
+		                          rule, *new_andbit);
+	}
+}
+
+void BackwardChainer::expand_bit_multithread()
+{
+	// Select distinct pairs of and-BIT and leaf to expand,
+	// sequentially as it is cheap compared to the expansions
+	// themselves. As they are drawn with replacement, the number of
+	// draws is bounded in case the BIT has less than URE:jobs pairs
+	// to offer.
+	int jobs = _config.get_jobs();
+	std::set<std::pair<const AndBIT*, Handle>> selected;
+	std::vector<WorkerPool::Task> tasks;
+	for (int draws = 0; (int)tasks.size() < jobs and draws < 2 * jobs; draws++) {
+		AndBIT* andbit = select_expansion_andbit();
+		BITNode* bitleaf = andbit->select_leaf(*_rng);
+		if (not bitleaf) {
+			ure_logger().debug() << "All BIT-nodes of this and-BIT are exhausted "
+			                     << "(or possibly fulfilled). Abort expansion.";
+			_bit.set_exhausted(*andbit);
+			continue;
+		}
+		if (not selected.emplace(andbit, bitleaf->body).second)
+			continue;
+
+		// Only the BIT-node to expand is copied, so that workers do
+		// not read BIT-nodes while they are being modified by
+		// concurrent insertions. Each worker has its own random
+		// generator, seeded here to remain reproducible.
+		Handle leaf = bitleaf->body;
+		AndBIT copy = andbit->leaf_copy(leaf);
+		unsigned long seed = _rng->randint(std::numeric_limits<int>::max());
+		tasks.push_back([this, copy, leaf, seed]() mutable {
+				MT19937RandGen rng(seed);
+				expand_bit_worker(copy, leaf, rng); });
+	}
+
+	LAZY_URE_LOG_DEBUG << "Expand " << tasks.size()
+	                   << " and-BITs in parallel";
+
+	// Expand them in parallel
+	_expansion_workers.run(tasks);
+}
+
+void BackwardChainer::expand_bit_worker(AndBIT& andbit, const Handle& leaf,
+                                        RandGen& rng)
+{
+	BITNode& bitleaf = andbit.leaf2bitnode.find(leaf)->second;
+
+	// Select rule for expansion, on the copy
+	Rule rule;
+	Unify::TypedSubstitution ts;
+	double prob;
+	if (not select_expansion_rule(andbit, bitleaf, rng, rule, ts, prob)) {
+		// Report back to the BIT that the BIT-node is exhausted
+		if (bitleaf.exhausted) {
+			_bit.set_exhausted(andbit.fcs, leaf);
+			record_tabled_completion(andbit, leaf);
+		}
+		return;
+	}
+
+	// Make sure that the rule is not already an or-child of bitleaf
+	// before going through the expansion. This is only a hint as the
+	// copy may be outdated, the definite check occurs at insertion.
+	RuleTypedSubstitutionPair rtsp{rule, ts};
+	if (_bit.is_in(rtsp, bitleaf)) {
+		ure_logger().debug() << "An equivalent rule has already expanded "
+		                     << "that BIT-node, abort expansion";
+		return;
+	}
+
+	// Expand the copy and insert the result in the BIT
+	AndBIT new_andbit = andbit.expand(leaf, rtsp, prob);
+	if (not _bit.insert_expansion(andbit.fcs, leaf, rtsp, new_andbit))
+		return;
+
+	// Record the expansion in the trace atomspace. new_andbit is used
+	// rather than its inserted copy, as it only needs its FCS.
+	_trace_recorder.andbit(new_andbit);
+	_trace_recorder.expansion(andbit.fcs, leaf, rule, new_andbit);
+
+	std::lock_guard<std::mutex> lock(_expansion_mutex);
+	_last_expansion_fcss.push_back(new_andbit.fcs);
+	record_expansion_rule(new_andbit.fcs, rule);
+	record_tabled_expansion(andbit, leaf, rule, new_andbit.fcs);
+}
+
+bool BackwardChainer::select_expansion_rule(AndBIT& andbit, BITNode& bitleaf,
+                                            RandGen& rng, Rule& rule,
+                                            Unify::TypedSubstitution& ts,
+                                            double& prob)
+{
+	RuleSelection rule_sel = _control.select_rule(andbit, bitleaf, rng);
+	rule = rule_sel.first.first;
+	ts = rule_sel.first.second;
+	prob = rule_sel.second;
 
 	// Add the rule in the _bit.bit_as to make comparing atoms easier
 	// as well as logging more consistent.
@@ -208,33 +593,19 @@ void BackwardChainer::expand_bit(AndBIT& andbit)
 	if (not rule.is_valid()) {
 		ure_logger().debug("No valid rule for the selected BIT-node, "
 		                   "abort expansion");
-		return;
+		return false;
 	} else if (rule.has_cycle()) {
 		LAZY_URE_LOG_DEBUG << "The following rule has cycle (some premise "
 		                   << "equals to conclusion), abort expansion:"
 		                   << std::endl << rule.to_string();
-		return;
+		return false;
 	}
 
 	// Rule seems well, expand
 	LAZY_URE_LOG_DEBUG << "Selected rule, with probability " << prob
 	                   << " of success:" << std::endl << rule.to_string();
 
-	// Expand andbit. Warning: after this call the reference on andbit
-	// and bitleaf may no longer be valid because the container of
-	// and-BITs might have been resorted. so we keep track of their
-	// bodies for future use.
-	Handle andbit_fcs = andbit.fcs;
-	Handle bitleaf_body = bitleaf->body;
-	RuleTypedSubstitutionPair rtsp{rule, ts};
-	_last_expansion_andbit = _bit.expand(andbit, *bitleaf, rtsp, prob);
-
-	// Record the expansion in the trace atomspace
-	if (_last_expansion_andbit) {
-		_trace_recorder.andbit(*_last_expansion_andbit);
-		_trace_recorder.expansion(andbit_fcs, bitleaf_body,
-		                          rule, *_last_expansion_andbit);
-	}
+	return true;
 }
 
 void BackwardChainer::fulfill_bit()
@@ -244,25 +615,58 @@ void BackwardChainer::fulfill_bit()
 		return;
 	}
 
-	// Select an and-BIT for fulfillment
-	const AndBIT* andbit = select_fulfillment_andbit();
-	if (andbit == nullptr) {
+	// Select and-BITs for fulfillment, including the ones loaded
+	// from a snapshot, if not fulfilled yet
+	HandleSeq fcss = select_fulfillment_fcss();
+	fcss.insert(fcss.end(), _snapshot_fcss.begin(), _snapshot_fcss.end());
+	_snapshot_fcss.clear();
+	if (fcss.empty()) {
 		ure_logger().debug() << "Cannot fulfill an empty and-BIT. "
 		                    << "Abort BIT fulfillment";
 		return;
 	}
-	LAZY_URE_LOG_DEBUG << "Selected and-BIT for fulfillment (fcs value):"
-	                   << std::endl << andbit->fcs->id_to_string();
 
-	// Wrap in a try/catch in case the pattern matcher can't handle
-	// it.
-	try {
-		fulfill_fcs(andbit->fcs);
-	} catch (...) {}
+	for (const Handle& selected_fcs : fcss) {
+		// Only now build the FCS in the BIT atomspace
+		Handle fcs = _bit.materialize(selected_fcs);
+
+		LAZY_URE_LOG_DEBUG << "Selected and-BIT for fulfillment (fcs value):"
+		                   << std::endl << fcs->id_to_string();
+
+		// Either hand it over to the fulfillment workers, or run
+		// it right away. Wrap in a try/catch in case the pattern
+		// matcher can't handle it.
+		if (_fulfillment.is_started()) {
+			_fulfillment.push(fcs);
+		} else {
+			try {
+				fulfill_fcs(fcs);
+			} catch (...) {}
+		}
+	}
+
+	// Record the results of the fulfillments completed in the
+	// background so far
+	collect_fulfillments();
 }
 
 void BackwardChainer::fulfill_fcs(const Handle& fcs)
 {
+	record_results(fcs, execute_fcs(fcs));
+}
+
+HandleSeq BackwardChainer::execute_fcs(const Handle& fcs)
+{
+	// Skip the pattern matcher if fcs has already been run against
+	// the current knowledge base
+	bool use_cache = _config.get_fulfillment_cache();
+	KBVersion version = kb_version();
+	HandleSeq results;
+	if (use_cache and _fulfillment_cache.get(fcs, version, results)) {
+		LAZY_URE_LOG_DEBUG << "Cached results:" << std::endl << results;
+		return results;
+	}
+
 	// Temporary atomspace to not pollute _as with intermediary
 	// results
 	AtomSpace tmp_as(&_kb_as);
@@ -282,105 +686,338 @@ void BackwardChainer::fulfill_fcs(const Handle& fcs)
 	// TODO: Maybe we could take advantage of the new read-only
 	// capabilities of the AtomSpace.
 	Handle hresult = HandleCast(fcs->execute(&tmp_as));
-	HandleSeq results;
 	for (const Handle& result : hresult->getOutgoingSet())
 		results.push_back(_kb_as.add_atom(result));
 	LAZY_URE_LOG_DEBUG << "Results:" << std::endl << results;
-	_results.insert(results.begin(), results.end());
+
+	// Results may have modified the TVs of existing atoms, thus
+	// changing the knowledge base without changing its size.
+	unsigned long updates = results.empty() ?
+		_kb_updates.load() : ++_kb_updates;
+
+	// Only cache if no other fulfillment has concurrently modified
+	// the knowledge base, as it may or may not have been taken into
+	// account by that run.
+	if (use_cache and updates == version.updates + (results.empty() ? 0 : 1))
+		_fulfillment_cache.set(fcs, kb_version(), results);
+
+	return results;
+}
+
+KBVersion BackwardChainer::kb_version() const
+{
+	return KBVersion(_kb_as.get_size(), _kb_updates.load());
+}
+
+void BackwardChainer::record_results(const Handle& fcs, const HandleSeq& results)
+{
+	HandleSeq new_results;
+	for (const Handle& result : results)
+		if (_results.insert(result).second)
+			new_results.push_back(result);
+
+	// Stream the new results. There is no single rule to report as
+	// the whole FCS has been run.
+	_result_stream.emit(_iteration, Handle::UNDEFINED, fcs, new_results);
 
 	// Record the results in _trace_as
 	for (const Handle& result : results)
 		_trace_recorder.proof(fcs, result);
+
+	// Learn from the outcome of the expansion that produced fcs
+	update_rule_tv(fcs, results);
+
+	// Let the other and-BITs reuse the proofs of its subgoals
+	record_tabled_proof(fcs, results);
 }
 
-std::vector<double> BackwardChainer::expansion_andbit_weights()
+void BackwardChainer::collect_fulfillments()
 {
-	std::vector<double> weights;
-	for (const AndBIT& andbit : _bit.andbits)
-		weights.push_back(operator()(andbit));
-	return weights;
+	Fulfillments fulfillments;
+	_fulfillment.drain(fulfillments);
+	for (const Fulfillment& ff : fulfillments)
+		record_results(ff.first, ff.second);
 }
 
-AndBIT* BackwardChainer::select_expansion_andbit()
+void BackwardChainer::record_expansion_rule(const Handle& fcs, const Rule& rule)
+{
+	if (_config.get_rule_tv_learning())
+		_expansion_rules[fcs] = rule.get_alias();
+}
+
+void BackwardChainer::update_rule_tv(const Handle& fcs, const HandleSeq& results)
+{
+	// No lock is needed as the expansions are over by the time
+	// fulfillments are recorded.
+	auto it = _expansion_rules.find(fcs);
+	if (it == _expansion_rules.end())
+		return;
+
+	// An expansion is deemed successful if its and-BIT is a proof of
+	// the target, that is its FCS has produced results.
+	_control.update_rule_tv(it->second, not results.empty());
+	_expansion_rules.erase(it);
+}
+
+void BackwardChainer::record_tabled_expansion(const AndBIT& andbit,
+                                              const Handle& leaf,
+                                              const Rule& rule,
+                                              const Handle& new_fcs)
+{
+	if (not _config.get_goal_tabling())
+		return;
+
+	Handle vardecl = BindLinkCast(andbit.fcs)->get_vardecl();
+	GoalTable::Expansion expansion = GoalTable::expansion(leaf, vardecl, rule);
+	_goal_table.add_expansion(expansion);
+
+	// The and-BIT inherits the expansions of its parent
+	Expansions expansions;
+	auto it = _tabled_expansions.find(andbit.fcs);
+	if (it != _tabled_expansions.end())
+		expansions = it->second;
+	expansions.push_back(expansion);
+	_tabled_expansions[new_fcs] = std::move(expansions);
+}
+
+void BackwardChainer::record_tabled_completion(const AndBIT& andbit,
+                                               const Handle& leaf)
+{
+	if (not _config.get_goal_tabling())
+		return;
+
+	Handle vardecl = BindLinkCast(andbit.fcs)->get_vardecl();
+	_goal_table.set_complete(GoalTable::goal(leaf, vardecl));
+}
+
+void BackwardChainer::record_tabled_proof(const Handle& fcs,
+                                          const HandleSeq& results)
+{
+	// A failed FCS tells nothing about its expansions, as the
+	// failure may be due to any of its leaves.
+	if (results.empty())
+		return;
+
+	// No lock is needed as the expansions are over by the time
+	// fulfillments are recorded.
+	auto it = _tabled_expansions.find(fcs);
+	if (it == _tabled_expansions.end())
+		return;
+
+	// All expansions that have led to the proof are part of it
+	for (const GoalTable::Expansion& expansion : it->second) {
+		GoalTable::Consumers consumers = _goal_table.add_proof(expansion);
+		_tabled_feeds.insert(_tabled_feeds.end(),
+		                     consumers.begin(), consumers.end());
+	}
+}
+
+void BackwardChainer::table_andbits(const HandleSeq& fcss)
+{
+	for (const Handle& fcs : fcss) {
+		// The and-BIT may have been evicted in the meantime
+		AndBIT* andbit = _bit.find(fcs);
+		if (andbit)
+			table_andbit(*andbit);
+	}
+}
+
+void BackwardChainer::table_andbit(AndBIT& andbit)
+{
+	Handle vardecl = BindLinkCast(andbit.fcs)->get_vardecl();
+	for (auto& lb : andbit.leaf2bitnode) {
+		BITNode& bitnode = lb.second;
+		Handle goal = GoalTable::goal(bitnode.body, vardecl);
+		if (not _goal_table.contains(goal))
+			continue;
+
+		// Valid rules depend on the variable declaration of the
+		// and-BIT, thus may differ from the ones of the and-BIT where
+		// the subgoal has been completed.
+		bool unknown = false;
+		for (const auto& rule : _control.get_valid_rules(andbit, bitnode)) {
+			GoalTable::Expansion expansion =
+				GoalTable::expansion(bitnode.body, vardecl, rule.first);
+			GoalTable::Status status = _goal_table.status(expansion);
+			if (status == GoalTable::Status::EXPANDED) {
+				// Being searched from another and-BIT, without
+				// success so far, do not search it again but wait to
+				// be fed with its proof, see feed_tabled_consumers.
+				bitnode.rules.insert(rule);
+				_goal_table.add_consumer(expansion, {andbit.fcs, bitnode.body,
+				                                     rule.first, rule.second});
+			} else if (status == GoalTable::Status::PROVEN) {
+				// Reuse the proof right away
+				replay_tabled_expansion(andbit, bitnode, rule);
+			} else {
+				unknown = true;
+			}
+		}
+
+		// All valid rules have been tried from other and-BITs, the
+		// proven ones have just been replayed.
+		if (not unknown and _goal_table.is_complete(goal))
+			bitnode.exhausted = true;
+	}
+}
+
+void BackwardChainer::replay_tabled_expansion(AndBIT& andbit, BITNode& bitnode,
+                                              const RuleTypedSubstitutionPair& rule)
+{
+	// Like in select_expansion_rule, the rule is added to bit_as
+	Rule replayed(rule.first);
+	replayed.add(_bit.bit_as);
+	RuleTypedSubstitutionPair rtsp{replayed, rule.second};
+	const AndBIT* new_andbit = _bit.expand(andbit, bitnode, rtsp);
+	if (not new_andbit)
+		return;
+
+	LAZY_URE_LOG_DEBUG << "Replayed proven expansion of subgoal:"
+	                   << std::endl << oc_to_string(bitnode.body);
+	_last_expansion_fcss.push_back(new_andbit->fcs);
+	_untabled_fcss.push_back(new_andbit->fcs);
+	record_expansion_rule(new_andbit->fcs, replayed);
+	record_tabled_expansion(andbit, bitnode.body, replayed, new_andbit->fcs);
+	_trace_recorder.andbit(*new_andbit);
+	_trace_recorder.expansion(andbit.fcs, bitnode.body, replayed, *new_andbit);
+}
+
+void BackwardChainer::feed_tabled_consumers()
 {
-	std::vector<double> weights = expansion_andbit_weights();
+	GoalTable::Consumers feeds(std::move(_tabled_feeds));
+	_tabled_feeds.clear();
+	for (const GoalTable::Consumer& consumer : feeds) {
+		// The and-BIT may have been evicted in the meantime
+		AndBIT* andbit = _bit.find(consumer.fcs);
+		if (andbit == nullptr)
+			continue;
+		auto it = andbit->leaf2bitnode.find(consumer.leaf);
+		if (it == andbit->leaf2bitnode.end())
+			continue;
+
+		// The rule has been marked as tried when skipped
+		BITNode& bitnode = it->second;
+		bitnode.rules.erase(consumer.rule);
+		replay_tabled_expansion(*andbit, bitnode, {consumer.rule, consumer.ts});
+	}
+}
+
+void BackwardChainer::reset_goal_table()
+{
+	for (const GoalTable::Consumer& consumer : _goal_table.consumers()) {
+		AndBIT* andbit = _bit.find(consumer.fcs);
+		if (andbit == nullptr)
+			continue;
+		auto it = andbit->leaf2bitnode.find(consumer.leaf);
+		if (it == andbit->leaf2bitnode.end())
+			continue;
+		it->second.rules.erase(consumer.rule);
+		it->second.exhausted = false;
+		andbit->exhausted = false;
+	}
+	_bit.andbits.reweight();
 
+	_goal_table.clear();
+	_tabled_feeds.clear();
+}
+
+AndBIT* BackwardChainer::select_expansion_andbit()
+{
 	// Debug log
 	if (ure_logger().is_debug_enabled()) {
-		OC_ASSERT(weights.size() == _bit.andbits.size());
 		std::stringstream ss;
 		ss << "Weighted and-BITs:";
-		for (size_t i = 0; i < weights.size(); i++)
-			ss << std::endl << weights[i] << " "
-			   << _bit.andbits[i].fcs->id_to_string();
+		for (const AndBIT& andbit : _bit.andbits)
+			ss << std::endl << _bit.andbits.weight(andbit) << " "
+			   << andbit.fcs->id_to_string();
 		ure_logger().debug() << ss.str();
 	}
 
-	// Sample andbits according to this distribution
-	std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
-	return &rand_element(_bit.andbits, dist);
+	// Sample andbits according to their weights, maintained
+	// incrementally by the BIT. If all weights are null, which may
+	// happen if the fitness function is null everywhere, then sample
+	// uniformly.
+	AndBIT* andbit = _bit.andbits.sample(*_rng);
+	if (andbit == nullptr) {
+		size_t i = _rng->randdouble() * _bit.andbits.size();
+		andbit = &*std::next(_bit.andbits.begin(), i);
+	}
+	return andbit;
 }
 
-const AndBIT* BackwardChainer::select_fulfillment_andbit() const
+HandleSeq BackwardChainer::select_fulfillment_fcss() const
 {
-	return _last_expansion_andbit;
+	return _last_expansion_fcss;
 }
 
 void BackwardChainer::reduce_bit()
 {
-	if (0 < _config.get_max_bit_size()) {
-		// If the BIT size has reached its maximum, randomly remove
-		// and-BITs so that the BIT size gets back below or equal to
-		// its maximum.
-		while (_config.get_max_bit_size() < _bit.size()) {
-			// Randomly select an and-BIT that is unlikely to be used
-			// for the remaining of the inferenceThe and-BITs to remove are
-			// selected so that the least likely and-BITs to be
-			// selected for expansion are removed first.
-			remove_unlikely_expandable_andbit();
-		}
+	int max_size = _config.get_max_bit_size();
+	if (max_size <= 0 or _bit.size() <= (size_t)max_size)
+		return;
+
+	// The BIT size has exceeded its maximum (the high watermark),
+	// remove and-BITs in one batch so that its size gets back to the
+	// low watermark, leaving room for subsequent expansions.
+	double ratio = std::min(std::max(_config.get_bit_low_watermark(), 0.0), 1.0);
+	size_t low_size = std::max<size_t>(max_size * ratio, 1);
+	HandleSeq victims = select_unlikely_expandable_andbits(_bit.size() - low_size);
+
+	LAZY_URE_LOG_DEBUG << "Remove " << victims.size()
+	                   << " and-BITs from the BIT:" << std::endl
+	                   << oc_to_string(victims);
+	_bit.erase(victims);
+	for (const Handle& fcs : victims) {
+		_tabled_expansions.erase(fcs);
+		_fulfillment_cache.erase(fcs);
 	}
+	_control.forget_activities(victims);
 }
 
-void BackwardChainer::remove_unlikely_expandable_andbit()
+HandleSeq BackwardChainer::select_unlikely_expandable_andbits(size_t n)
 {
-	std::vector<double> weights = expansion_andbit_weights();
-	std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
-	std::vector<double> never_expand_probs;
-
 	// Calculate the probability of never being expanded for the
 	// remainder of the inference, thus (1-p) raised to the power of
-	// _config.get_maximum_iterations() - _iteration. This makes
-	// the assumption that the BIT (i.e. its and-BIT population) is
-	// not gonna change from this point on, a false but OK assumption
-	// for now.
-	for (double p : dist.probabilities()) {
-		double remaining_iterations =
-			_config.get_maximum_iterations() - _iteration;
-		double nep = std::pow(1 - p, remaining_iterations);
-		never_expand_probs.push_back(nep);
-	}
+	// _config.get_maximum_iterations() - _iteration, where p is the
+	// probability of being selected for expansion. This makes the
+	// assumption that the BIT (i.e. its and-BIT population) is not
+	// gonna change from this point on, a false but OK assumption for
+	// now. If the number of iterations is unlimited then consider a
+	// single remaining iteration.
+	double total = _bit.andbits.total_weight();
+	double remaining_iterations = std::max(1.0,
+		(double)_config.get_maximum_iterations() - _iteration);
 
-	// Fine log
-	if (ure_logger().is_fine_enabled()) {
-		OC_ASSERT(never_expand_probs.size() == _bit.andbits.size());
-		std::stringstream ss;
-		ss << "Never expand probs and-BITs:";
-		for (size_t i = 0; i < never_expand_probs.size(); i++)
-			ss << std::endl << never_expand_probs[i] << " "
-			   << _bit.andbits[i].fcs->id_to_string();
-		ure_logger().fine() << ss.str();
+	// Select the and-BITs to remove in one pass, by weighted sampling
+	// without replacement (Efraimidis and Spirakis), using the never
+	// expand probabilities as weights. Each and-BIT gets the key
+	// log(u)/w, u being uniformly drawn in (0, 1], and the n and-BITs
+	// with the highest keys are selected. Working with logarithms
+	// avoids underflows when weights are small.
+	typedef std::pair<double, Handle> KeyFCS;
+	std::vector<KeyFCS> keys;
+	keys.reserve(_bit.size());
+	for (const AndBIT& andbit : _bit.andbits) {
+		double p = 0 < total ? _bit.andbits.weight(andbit) / total : 0.0;
+		double nep = std::exp(remaining_iterations * std::log1p(-std::min(p, 1.0)));
+		double u = 1.0 - _rng->randdouble();
+		double key = 0 < nep ? std::log(u) / nep
+			: -std::numeric_limits<double>::infinity();
+		keys.emplace_back(key, andbit.fcs);
+
+		LAZY_URE_LOG_FINE << "Never expand prob " << nep << " of "
+		                  << andbit.fcs->id_to_string();
 	}
 
-	std::discrete_distribution<size_t>
-		never_expand_dist(never_expand_probs.begin(), never_expand_probs.end());
+	n = std::min(n, keys.size());
+	auto greater_key = [](const KeyFCS& l, const KeyFCS& r) {
+		return l.first > r.first; };
+	std::nth_element(keys.begin(), keys.begin() + n, keys.end(), greater_key);
 
-	// Pick the and-BIT, remove it from the BIT and remove its
-	// FCS from the bit atomspace.
-	auto it = std::next(_bit.andbits.begin(), never_expand_dist(randGen()));
-	LAZY_URE_LOG_DEBUG << "Remove " << it->fcs->id_to_string()
-	                   << " from the BIT";
-	_bit.erase(it);
+	HandleSeq victims;
+	for (size_t i = 0; i < n; i++)
+		victims.push_back(keys[i].second);
+	return victims;
 }
 
 double BackwardChainer::complexity_factor(const AndBIT& andbit) const
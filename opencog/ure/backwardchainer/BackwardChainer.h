@@ -25,11 +25,21 @@
 #ifndef _OPENCOG_BACKWARDCHAINER_H_
 #define _OPENCOG_BACKWARDCHAINER_H_
 
+#include <atomic>
+#include <mutex>
+
 #include "../Rule.h"
 #include "../UREConfig.h"
+#include "../ResultStream.h"
+#include "../UREBudget.h"
+#include "../CancellationToken.h"
 #include "BIT.h"
 #include "TraceRecorder.h"
 #include "ControlPolicy.h"
+#include "FulfillmentPipeline.h"
+#include "FulfillmentCache.h"
+#include "WorkerPool.h"
+#include "GoalTable.h"
 
 class BackwardChainerUTest;
 
@@ -138,6 +148,24 @@ public:
 	                const BITNodeFitness& bitnode_fitness=BITNodeFitness(),
 	                const AndBITFitness& andbit_fitness=AndBITFitness());
 
+	/**
+	 * Like above, but copy the given configuration rather than
+	 * fetching it from the rule base, and, if provided, reuse the
+	 * expansion control rules of another chainer rather than fetching
+	 * them from control_as, see ControlPolicy::get_expansion_control_rules.
+	 * Meant to run many queries over the same rule base, see
+	 * BatchBackwardChainer.
+	 */
+	BackwardChainer(AtomSpace& kb_as,
+	                const UREConfig& config,
+	                const Handle& target,
+	                const Handle& vardecl=Handle::UNDEFINED,
+	                AtomSpace* trace_as=nullptr,
+	                AtomSpace* control_as=nullptr,
+	                const ExpansionControlRulesPtr& exp_ctrl_rules=nullptr,
+	                const BITNodeFitness& bitnode_fitness=BITNodeFitness(),
+	                const AndBITFitness& andbit_fitness=AndBITFitness());
+
 	/**
 	 * URE configuration accessors
 	 */
@@ -150,8 +178,57 @@ public:
 	 */
 	void do_chain();
 
+	/**
+	 * Perform backward chaining inference for at most max_steps
+	 * iterations and max_ms milliseconds, negative meaning
+	 * unlimited, or till the termination criteria have been met.
+	 *
+	 * It can be called repeatedly to resume chaining where it was
+	 * left, the BIT and all other state being kept in between. The
+	 * pending fulfillments are completed before returning, so that
+	 * nothing runs in the background between calls, and the time
+	 * spent between calls does not count toward the time budget.
+	 *
+	 * @return true iff the termination criteria have been met, in
+	 *         which case chaining is over, as after do_chain(), and
+	 *         subsequent calls do nothing.
+	 */
+	bool run(int max_steps, int max_ms=-1);
+
+	/**
+	 * Return true iff chaining is over.
+	 */
+	bool is_finished() const;
+
+	/**
+	 * Write the BIT to filename, so that a subsequent backward
+	 * chainer on the same target, possibly after some changes in the
+	 * knowledge base, can start from it with load_snapshot, rather
+	 * than rebuilding it from scratch, see BIT::save.
+	 *
+	 * The file is written to filename.tmp then renamed.
+	 */
+	void save_snapshot(const std::string& filename) const;
+
+	/**
+	 * Warm start from the BIT saved by save_snapshot, before starting
+	 * chaining. The loaded and-BITs are fulfilled along with the first
+	 * expansion, so that their proofs are found right away, then the
+	 * BIT keeps being expanded from where it was. The iteration count
+	 * starts over.
+	 *
+	 * Throw a RuntimeException if chaining has already started or the
+	 * snapshot is ill-formed, or of another rule base or target, or
+	 * of rules with other aliases or bodies.
+	 */
+	void load_snapshot(const std::string& filename);
+
 	/**
 	 * Perform a single backward chaining inference step.
+	 *
+	 * If URE:jobs is greater than 1, then as many and-BITs are
+	 * expanded in parallel during that step, and all resulting
+	 * and-BITs are fulfilled.
 	 */
 	void do_step();
 
@@ -159,11 +236,42 @@ public:
 	 * @return true if the termination criteria have been met.
 	 *
 	 * More specifically, either
-	 * 1. reached the maximum number of iterations,
-	 * 2. or all andbits are exhausted.
+	 * 1. has been cancelled,
+	 * 2. or reached the maximum number of iterations,
+	 * 3. or all andbits are exhausted,
+	 * 4. or exceeded the time, atoms created or memory budget.
 	 */
 	bool termination();
 
+	/**
+	 * Request the chaining to stop. Can be called from any thread,
+	 * do_chain() then returns at the end of the current step, with
+	 * the results found so far.
+	 */
+	void cancel();
+	bool is_cancelled() const;
+
+	/**
+	 * Replace the cancellation token, for instance to share it with
+	 * other chainers, see CancellationToken.
+	 */
+	void set_cancellation_token(const CancellationTokenPtr& token);
+	const CancellationTokenPtr& get_cancellation_token() const;
+
+	/**
+	 * Set the random generator used to select the and-BITs, their
+	 * leaves and the rules to expand them with, randGen() by
+	 * default. Chainers running in parallel should each have their
+	 * own, see BatchBackwardChainer.
+	 */
+	void set_random_generator(RandGen& rng);
+
+	/**
+	 * Number of iterations done so far. Can be called from any
+	 * thread, to monitor progress.
+	 */
+	int get_iteration() const;
+
 	/**
 	 * Get the current result on the initial target, a SetLink with
 	 * all inferred atoms matching the target.
@@ -171,7 +279,20 @@ public:
 	Handle get_results() const;
 	const HandleSet& get_results_set() const;
 
+	/**
+	 * Stream delivering each new result as soon as an FCS fulfilling
+	 * it has been run, see ResultStream. It is closed at the end of
+	 * do_chain().
+	 */
+	ResultStream& get_result_stream();
+
 private:
+	// Set up chaining, called by the first run()
+	void start_chain();
+
+	// Wrap up chaining, called by the last run()
+	void finish_chain();
+
 	void expand_meta_rules();
 
 	// Expand the BIT
@@ -181,6 +302,24 @@ private:
 	// will keep a record of the expansion if successful.
 	void expand_bit(AndBIT& andbit);
 
+	// Select up to URE:jobs distinct pairs of and-BIT and leaf, and
+	// expand them in parallel, see _expansion_workers.
+	void expand_bit_multithread();
+
+	// Expand a copy of an and-BIT of the BIT, holding only the
+	// BIT-node of the given leaf, see AndBIT::leaf_copy, then insert
+	// the result in the BIT. Rule selection and unification take
+	// place on the copy, without locking the BIT, so that multiple
+	// workers can run concurrently.
+	void expand_bit_worker(AndBIT& andbit, const Handle& leaf, RandGen& rng);
+
+	// Select a rule to expand bitleaf of andbit. Return false if no
+	// valid rule could be selected. The BIT is not modified, beside
+	// possibly setting the exhausted flag of bitleaf.
+	bool select_expansion_rule(AndBIT& andbit, BITNode& bitleaf, RandGen& rng,
+	                           Rule& rule, Unify::TypedSubstitution& ts,
+	                           double& prob);
+
 	// Fulfill the BIT. That is run some or all its and-BITs
 	void fulfill_bit();
 
@@ -188,23 +327,90 @@ private:
 	// strategy.
 	void fulfill_fcs(const Handle& fcs);
 
+	// Run an FCS and add its results to the knowledge base. Can be
+	// called concurrently by the fulfillment workers.
+	HandleSeq execute_fcs(const Handle& fcs);
+
+	// Return the current version of the knowledge base, see
+	// KBVersion.
+	KBVersion kb_version() const;
+
+	// Record the results of an FCS, in _results, the result stream
+	// and the trace. Only called by the chaining thread.
+	void record_results(const Handle& fcs, const HandleSeq& results);
+
+	// Record the results of the fulfillments completed by the
+	// fulfillment workers so far.
+	void collect_fulfillments();
+
+	// Remember the rule that has produced the and-BIT of the given
+	// FCS, if rule TV learning is enabled.
+	void record_expansion_rule(const Handle& fcs, const Rule& rule);
+
+	// Update the TV of the rule that has produced the and-BIT of the
+	// given FCS, according to whether running it has produced
+	// results, see UREConfig::get_rule_tv_learning.
+	void update_rule_tv(const Handle& fcs, const HandleSeq& results);
+
+	// Record in the goal table, if enabled, that leaf of andbit has
+	// been expanded by rule into the and-BIT of new_fcs, and keep
+	// track of the expansions that have led to it.
+	void record_tabled_expansion(const AndBIT& andbit, const Handle& leaf,
+	                             const Rule& rule, const Handle& new_fcs);
+
+	// Record in the goal table, if enabled, that the subgoal of leaf
+	// of andbit is complete, as all valid rules have expanded it.
+	void record_tabled_completion(const AndBIT& andbit, const Handle& leaf);
+
+	// Record in the goal table, if enabled, that the expansions that
+	// have led to the and-BIT of fcs have proven their subgoals, if
+	// its FCS has produced results. Nothing is recorded otherwise, as
+	// the failure may be due to any leaf. The consumers of the newly
+	// proven expansions are kept to be fed at the next expansion.
+	void record_tabled_proof(const Handle& fcs, const HandleSeq& results);
+
+	// Apply the goal table to the BIT-nodes of the and-BITs of the
+	// given FCSs. Rules that have already expanded the same subgoal
+	// in other and-BITs are marked as tried, and the BIT-node
+	// registered as consumer, the ones that have led to proofs are
+	// replayed right away. BIT-nodes of complete subgoals are set as
+	// exhausted, unless some of their valid rules in that and-BIT
+	// are unknown to the table.
+	void table_andbits(const HandleSeq& fcss);
+	void table_andbit(AndBIT& andbit);
+
+	// Expand the BIT-node of andbit by a rule whose expansion of the
+	// same subgoal has been proven in another and-BIT. The premises
+	// of the new and-BIT are tabled in turn, so that the rest of the
+	// proven fragment is replayed subgoal by subgoal.
+	void replay_tabled_expansion(AndBIT& andbit, BITNode& bitnode,
+	                             const RuleTypedSubstitutionPair& rule);
+
+	// Feed the consumers of the expansions proven since the last
+	// expansion, if their and-BITs are still in the BIT.
+	void feed_tabled_consumers();
+
+	// Clear the goal table, as it may no longer hold, for instance
+	// because the knowledge base or the rule set has changed. The
+	// rules that consumers have skipped are no longer marked as
+	// tried, so that they get searched again.
+	void reset_goal_table();
+
 	// Reduce the BIT. Remove some and-BITs.
 	void reduce_bit();
 
-	// Pick up an and-BIT randomly, biased so that this and-BIT is
-	// unlikely to be expanded for the remainder of the inference.
-	void remove_unlikely_expandable_andbit();
+	// Pick up n and-BITs randomly, without replacement, biased so
+	// that these and-BITs are unlikely to be expanded for the
+	// remainder of the inference. Return their FCSs.
+	HandleSeq select_unlikely_expandable_andbits(size_t n);
 
-	// Calculate distribution based on a (poor) estimate of the
-	// probablity of a and-BIT being within the path of the solution.
-	std::vector<double> expansion_andbit_weights();
-
-	// Select an and-BIT for expansion
+	// Select an and-BIT for expansion, according to the weights
+	// maintained by the BIT, in O(log n).
 	AndBIT* select_expansion_andbit();
 
-	// Select an and-BIT for fulfilment. Return nullptr if none have
-	// been selected.
-	const AndBIT* select_fulfillment_andbit() const;
+	// Select the FCSs of the and-BITs for fulfilment. Return an empty
+	// sequence if none have been selected.
+	HandleSeq select_fulfillment_fcss() const;
 
 	// Return the complexity factor of an andbit. The formula is
 	//
@@ -219,12 +425,16 @@ private:
 	// results will be dumped.
 	AtomSpace& _kb_as;
 
-	// Atomspace containing the rule base, can be the same as _kb_as
-	AtomSpace& _rb_as;
+	// Holds the FCSs and specialized rules loaded by load_snapshot,
+	// for the lifetime of the chainer.
+	AtomSpace _snapshot_as;
 
 	// Contain the configuration
 	UREConfig _config;
 
+	// Keep track of time, atoms and memory budgets
+	UREBudget _budget;
+
 	// Structure holding the Back Inference Tree
 	BIT _bit;
 
@@ -240,13 +450,81 @@ private:
 	// Reference to the control policy rule set
 	RuleSet& _rules;
 
-	int _iteration;
+	std::atomic<int> _iteration;
 
-	// Keep track of the and-BIT of the last expansion. Null if the
-	// last expansion has failed.
-	const AndBIT* _last_expansion_andbit;
+	// Raised by cancel()
+	CancellationTokenPtr _cancellation;
+
+	// Random generator of the selections, see set_random_generator
+	RandGen* _rng;
+
+	// Whether chaining has started and is over, see run()
+	bool _started;
+	bool _finished;
+
+	// Keep track of the FCSs of the and-BITs of the last expansions
+	// (a single one unless multithreaded). Empty if the last
+	// expansions have failed.
+	HandleSeq _last_expansion_fcss;
+
+	// FCSs of the and-BITs loaded from a snapshot, waiting to be
+	// fulfilled, see load_snapshot.
+	HandleSeq _snapshot_fcss;
+
+	// Map the FCSs of the and-BITs waiting for fulfillment to the
+	// alias of the rule of the expansion that produced them. Only
+	// maintained if rule TV learning is enabled. FCSs are compared by
+	// content as they do not belong to any atomspace until
+	// fulfillment, see AndBIT::fcs.
+	std::map<Handle, Handle, content_based_handle_less> _expansion_rules;
+
+	// Protect _last_expansion_fcss and _expansion_rules during
+	// multithreaded expansions
+	std::mutex _expansion_mutex;
 
 	HandleSet _results;
+
+	// Stream of results, delivered as they are derived
+	ResultStream _result_stream;
+
+	// Number of fulfillments that have produced results, part of the
+	// version of the knowledge base, see KBVersion.
+	std::atomic<unsigned long> _kb_updates;
+
+	// Results of the FCSs already run, when URE:BC:fulfillment-cache
+	// is enabled
+	FulfillmentCache _fulfillment_cache;
+
+	// Run FCSs in the background when URE:BC:fulfillment-jobs is
+	// positive, while the BIT keeps being expanded
+	FulfillmentPipeline _fulfillment;
+
+	// Expand the BIT in parallel when URE:jobs is above 1, kept
+	// running for the whole run()
+	WorkerPool _expansion_workers;
+
+	// Subgoals shared by all and-BITs, when URE:BC:goal-tabling is
+	// enabled
+	GoalTable _goal_table;
+
+	// Map the FCSs of the and-BITs to the expansions that have led to
+	// them from the initial and-BIT, in canonical form. Only
+	// maintained if goal tabling is enabled. Like _expansion_rules,
+	// FCSs are compared by content, and it is protected by
+	// _expansion_mutex.
+	typedef std::vector<GoalTable::Expansion> Expansions;
+	std::map<Handle, Expansions, content_based_handle_less> _tabled_expansions;
+
+	// FCSs of the and-BITs produced by replaying proven expansions,
+	// to which the goal table is applied at the next iteration.
+	HandleSeq _untabled_fcss;
+
+	// Consumers of the expansions proven since the last expansion
+	GoalTable::Consumers _tabled_feeds;
+
+	// Version of the knowledge base when chaining has been
+	// suspended, to reset the goal table on resume if it has changed
+	KBVersion _suspension_version;
 };
 
 
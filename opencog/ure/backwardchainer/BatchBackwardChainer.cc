@@ -0,0 +1,181 @@
+/*
+ * BatchBackwardChainer.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/util/mt19937ar.h>
+
+#include "BatchBackwardChainer.h"
+#include "BackwardChainer.h"
+#include "../URELogger.h"
+
+using namespace opencog;
+
+BatchBackwardChainer::BatchBackwardChainer(AtomSpace& kb_as,
+                                           const Handle& rbs,
+                                           const HandleSeq& targets,
+                                           const HandleSeq& vardecls,
+                                           AtomSpace* control_as)
+	: _kb_as(kb_as),
+	  _rb_as(rbs->getAtomSpace() ? *rbs->getAtomSpace() : kb_as),
+	  _rbs(rbs),
+	  _targets(targets),
+	  _vardecls(vardecls),
+	  _control_as(control_as),
+	  _jobs(0),
+	  _maximum_iterations(-1),
+	  _maximum_time(-1),
+	  _cancellation(std::make_shared<CancellationToken>()),
+	  _seed(0),
+	  _next(0),
+	  _results(targets.size())
+{
+	if (_vardecls.empty())
+		_vardecls.resize(_targets.size());
+	else if (_vardecls.size() != _targets.size())
+		throw RuntimeException(TRACE_INFO,
+			"BatchBackwardChainer - got %zu targets but %zu "
+			"variable declarations", _targets.size(), _vardecls.size());
+}
+
+void BatchBackwardChainer::set_jobs(unsigned jobs)
+{
+	_jobs = jobs;
+}
+
+unsigned BatchBackwardChainer::get_jobs() const
+{
+	if (0 < _jobs)
+		return _jobs;
+	return std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+void BatchBackwardChainer::set_maximum_iterations(int mi)
+{
+	_maximum_iterations = mi;
+}
+
+void BatchBackwardChainer::set_maximum_time(double mt)
+{
+	_maximum_time = mt;
+}
+
+void BatchBackwardChainer::do_chain()
+{
+	// Build the configuration once for all queries, rather than
+	// letting the workers race to build it
+	auto config = std::make_shared<UREConfig>(
+		*RuleBaseCache::instance().get(_rb_as, _rbs));
+	if (0 <= _maximum_iterations)
+		config->set_maximum_iterations(_maximum_iterations);
+	if (0 <= _maximum_time)
+		config->set_maximum_time(_maximum_time);
+	_config = config;
+
+	// Likewise fetch the expansion control rules once, with a policy
+	// over a dummy BIT
+	_exp_ctrl_rules = nullptr;
+	if (_control_as and not _targets.empty()) {
+		BIT bit;
+		ControlPolicy control(*_config, bit, _targets.front(), _control_as);
+		_exp_ctrl_rules = control.get_expansion_control_rules();
+	}
+
+	_seed = randGen().randint(std::numeric_limits<int>::max());
+
+	unsigned jobs = std::min<size_t>(get_jobs(), _targets.size());
+	LAZY_URE_LOG_DEBUG << "Start batch backward chaining of "
+	                   << _targets.size() << " targets with "
+	                   << jobs << " jobs";
+
+	_next = 0;
+	_exception = nullptr;
+	std::vector<std::thread> workers;
+	for (unsigned i = 1; i < jobs; i++)
+		workers.emplace_back(&BatchBackwardChainer::work, this);
+	// The calling thread is a worker too
+	work();
+	for (std::thread& worker : workers)
+		worker.join();
+
+	ure_logger().debug("Finished batch backward chaining");
+
+	if (_exception)
+		std::rethrow_exception(_exception);
+}
+
+void BatchBackwardChainer::cancel()
+{
+	_cancellation->cancel();
+}
+
+bool BatchBackwardChainer::is_cancelled() const
+{
+	return _cancellation->is_cancelled();
+}
+
+size_t BatchBackwardChainer::size() const
+{
+	return _targets.size();
+}
+
+const std::vector<HandleSet>& BatchBackwardChainer::get_results_sets() const
+{
+	return _results;
+}
+
+Handle BatchBackwardChainer::get_results() const
+{
+	HandleSeq sets;
+	for (const HandleSet& results : _results)
+		sets.push_back(_kb_as.add_link(SET_LINK,
+		                               HandleSeq(results.begin(), results.end())));
+	return _kb_as.add_link(LIST_LINK, std::move(sets));
+}
+
+void BatchBackwardChainer::run_query(size_t i)
+{
+	BackwardChainer bc(_kb_as, *_config, _targets[i], _vardecls[i],
+	                   nullptr, _control_as, _exp_ctrl_rules);
+	bc.set_cancellation_token(_cancellation);
+	MT19937RandGen rng(_seed + i);
+	bc.set_random_generator(rng);
+
+	bc.do_chain();
+	_results[i] = bc.get_results_set();
+}
+
+void BatchBackwardChainer::work()
+{
+	for (size_t i = _next++; i < _targets.size() and not is_cancelled();
+	     i = _next++) {
+		try {
+			run_query(i);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(_exception_mutex);
+			if (not _exception)
+				_exception = std::current_exception();
+		}
+	}
+}
@@ -0,0 +1,169 @@
+/*
+ * BatchBackwardChainer.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_BATCHBACKWARDCHAINER_H_
+#define _OPENCOG_BATCHBACKWARDCHAINER_H_
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "../CancellationToken.h"
+#include "../RuleBaseCache.h"
+#include "ControlPolicy.h"
+
+namespace opencog
+{
+
+/**
+ * Run a batch of independent backward chaining queries over the same
+ * knowledge base and rule base, on a pool of threads.
+ *
+ * Each query is run by its own BackwardChainer, built from the
+ * configuration and the expansion control rules shared by all
+ * queries, so that the rule base and the control atomspace are only
+ * queried once for the whole batch, see RuleBaseCache. The maximum
+ * number of iterations and time of each query can be set
+ * independently of the rule base, the default being those of the
+ * rule base.
+ *
+ * Each query has its own random generator, seeded from randGen() at
+ * the start of the batch and the index of the query, so that the
+ * results do not depend on the number of jobs nor on the order in
+ * which the workers pick up the queries.
+ *
+ * Workers pull queries in order till none are left, so that a slow
+ * query does not hold up the others. Results are returned per
+ * target, in the order of the targets.
+ */
+class BatchBackwardChainer
+{
+public:
+	/**
+	 * Ctor.
+	 *
+	 * @param kb_as       Knowledge-base atomspace
+	 * @param rbs         Rule-base concept, the rule-base atomspace
+	 *                    being the atomspace of rbs if any, kb_as
+	 *                    otherwise
+	 * @param targets     Targets to proof
+	 * @param vardecls    Variable declarations of the targets, either
+	 *                    empty or of the same size as targets, with
+	 *                    Handle::UNDEFINED for targets without
+	 * @param control_as  Atomspace containing control rules
+	 */
+	BatchBackwardChainer(AtomSpace& kb_as,
+	                     const Handle& rbs,
+	                     const HandleSeq& targets,
+	                     const HandleSeq& vardecls=HandleSeq(),
+	                     AtomSpace* control_as=nullptr);
+
+	/**
+	 * Set the number of queries run in parallel. 0, the default,
+	 * means as many as hardware threads.
+	 */
+	void set_jobs(unsigned jobs);
+	unsigned get_jobs() const;
+
+	/**
+	 * Set the budgets of each query. A negative value, the default,
+	 * means the budget of the rule base, see
+	 * UREConfig::get_maximum_iterations and
+	 * UREConfig::get_maximum_time.
+	 */
+	void set_maximum_iterations(int mi);
+	void set_maximum_time(double mt);
+
+	/**
+	 * Run all queries till their termination criteria have been
+	 * met. If a query throws, the remaining queries are still run,
+	 * then the first exception is rethrown.
+	 */
+	void do_chain();
+
+	/**
+	 * Request all queries to stop, can be called from any thread. The
+	 * queries in progress return the results found so far, and the
+	 * remaining ones are not run.
+	 */
+	void cancel();
+	bool is_cancelled() const;
+
+	/**
+	 * Return the number of queries.
+	 */
+	size_t size() const;
+
+	/**
+	 * Return the results of each query, in the order of the targets.
+	 */
+	const std::vector<HandleSet>& get_results_sets() const;
+
+	/**
+	 * Like above, but as a ListLink of SetLinks, added to the
+	 * knowledge base.
+	 */
+	Handle get_results() const;
+
+private:
+	// Run the i-th query and store its results
+	void run_query(size_t i);
+
+	// Pull and run queries till none are left
+	void work();
+
+	AtomSpace& _kb_as;
+
+	// Rule-base atomspace
+	AtomSpace& _rb_as;
+
+	const Handle _rbs;
+	const HandleSeq _targets;
+	HandleSeq _vardecls;
+	AtomSpace* _control_as;
+
+	unsigned _jobs;
+	int _maximum_iterations;
+	double _maximum_time;
+
+	// Shared by all queries, set at the start of do_chain
+	CancellationTokenPtr _cancellation;
+	UREConfigPtr _config;
+	ExpansionControlRulesPtr _exp_ctrl_rules;
+
+	// Seed of the random generator of the first query, the i-th query
+	// using _seed + i
+	unsigned long _seed;
+
+	// Index of the next query to run
+	std::atomic<size_t> _next;
+
+	std::vector<HandleSet> _results;
+
+	// First exception thrown by a query, if any
+	std::exception_ptr _exception;
+	std::mutex _exception_mutex;
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_BATCHBACKWARDCHAINER_H_ */
@@ -26,9 +26,7 @@
 #include <opencog/util/random.h>
 #include <opencog/util/algorithm.h>
 #include <opencog/unify/Unify.h>
-#include <opencog/atoms/core/MapLink.h>
 
-#include "../MixtureModel.h"
 #include "../ActionSelection.h"
 #include "../BetaDistribution.h"
 
@@ -41,9 +39,14 @@ using namespace opencog;
 #define an _query_as->add_node
 
 ControlPolicy::ControlPolicy(const UREConfig& ure_config, const BIT& bit,
-                             const Handle& target, AtomSpace* control_as) :
+                             const Handle& target, AtomSpace* control_as,
+                             const ExpansionControlRulesPtr& exp_ctrl_rules) :
 	rules(ure_config.get_rules()), _ure_config(ure_config),
-	_bit(bit), _target(target), _control_as(control_as), _query_as(nullptr)
+	_bit(bit), _target(target), _control_as(control_as), _query_as(nullptr),
+	_expansion_control_rules(exp_ctrl_rules),
+	_valid_rules_rule_count(0), _valid_rules_hits(0), _valid_rules_misses(0),
+	_mixed_tvs_cpx_penalty(ure_config.get_mm_complexity_penalty()),
+	_mixed_tvs_compressiveness(ure_config.get_mm_compressiveness())
 {
 	// Fetch default TVs for each inference rule (the TV on the member
 	// link connecting the rule to the rule base)
@@ -56,17 +59,32 @@ ControlPolicy::ControlPolicy(const UREConfig& ure_config, const BIT& bit,
 		ss << std::endl << rtv.second->to_string() << " " << oc_to_string(rtv.first);
 	ure_logger().debug() << ss.str();
 
-	// Fetches expansion control rules from _control_as
-	if (_control_as) {
+	if (not _control_as)
+		return;
+
+	// Fetches expansion control rules from _control_as, unless
+	// already fetched by another policy
+	if (not _expansion_control_rules) {
 		_query_as = new AtomSpace(_control_as);
+		auto fetched = std::make_shared<ExpansionControlRules>();
 		for (const Handle& rule_alias : rules.aliases()) {
 			HandleSet exp_ctrl_rules = fetch_expansion_control_rules(rule_alias);
-			_expansion_control_rules[rule_alias] = exp_ctrl_rules;
+			(*fetched)[rule_alias] = exp_ctrl_rules;
 
 			ure_logger().debug() << "Expansion control rules for "
 			                     << rule_alias->to_string()
 			                     << oc_to_string(exp_ctrl_rules);
 		}
+		_expansion_control_rules = fetched;
+	}
+
+	// Compile them and calculate their statistics once for all
+	for (const auto& rule_ctrl_rules : *_expansion_control_rules) {
+		for (const Handle& ctrl_rule : rule_ctrl_rules.second) {
+			compile(ctrl_rule);
+			_control_rule_stats[ctrl_rule] =
+				MixtureModel::model_stats(ctrl_rule);
+		}
 	}
 }
 
@@ -75,11 +93,19 @@ ControlPolicy::~ControlPolicy()
 	delete(_query_as);
 }
 
-RuleSelection ControlPolicy::select_rule(AndBIT& andbit, BITNode& bitleaf)
+RuleSelection ControlPolicy::select_rule(AndBIT& andbit, BITNode& bitleaf,
+                                         RandGen& rng)
 {
 	// The rule is randomly selected amongst the valid ones, with
 	// probability of selection being proportional to its weight.
 	const RuleTypedSubstitutionMap valid_rules = get_valid_rules(andbit, bitleaf);
+
+	// If cancelled the valid rules may be partial, do not select
+	// amongst them, and above all do not mark the leaf as exhausted as
+	// it would then be reported to the BIT and the goal table.
+	if (_cancellation and _cancellation->is_cancelled())
+		return RuleSelection();
+
 	if (valid_rules.empty()) {
 		bitleaf.exhausted = true;
 		return RuleSelection();
@@ -93,7 +119,18 @@ RuleSelection ControlPolicy::select_rule(AndBIT& andbit, BITNode& bitleaf)
 		LAZY_URE_LOG_DEBUG << ss.str();
 	}
 
-	return select_rule(andbit, bitleaf, valid_rules);
+	return select_rule(andbit, bitleaf, valid_rules, rng);
+}
+
+void ControlPolicy::update_rule_tv(const Handle& rule_alias, bool success)
+{
+	TruthValuePtr tv = rules.update_tv(rule_alias, success, not success);
+	if (not tv)
+		return;
+
+	_default_tvs[rule_alias] = tv;
+	LAZY_URE_LOG_FINE << "Update default TV of " << rule_alias->to_short_string()
+	                  << " to " << tv->to_string();
 }
 
 HandleSet ControlPolicy::rule_aliases(const RuleTypedSubstitutionMap& rules)
@@ -107,39 +144,131 @@ HandleSet ControlPolicy::rule_aliases(const RuleTypedSubstitutionMap& rules)
 RuleTypedSubstitutionMap ControlPolicy::get_valid_rules(const AndBIT& andbit,
                                                         const BITNode& bitleaf)
 {
-	// Generate all valid rules
+	// Get the leaf vardecl from fcs. We don't want to filter it
+	// because otherwise the typed substitution obtained may miss some
+	// variables in the FCS declaration that needs to be substituted
+	// during expension.
+	Handle vardecl;
+	if (andbit.fcs)
+		vardecl = BindLinkCast(andbit.fcs)->get_vardecl();
+
+	// Only keep unexplored rules for this leaf
 	RuleTypedSubstitutionMap valid_rules;
+	for (const auto& rule : unified_rules(bitleaf.body, vardecl))
+		if (not _bit.is_in(rule, bitleaf))
+			valid_rules.insert(rule);
+	return valid_rules;
+}
+
+RuleTypedSubstitutionMap ControlPolicy::unified_rules(const Handle& leaf,
+                                                      const Handle& vardecl)
+{
+	LeafKey key(leaf, vardecl);
+	{
+		std::lock_guard<std::mutex> lock(_valid_rules_mutex);
+
+		// Meta-rule expansion may have added rules
+		if (_valid_rules_rule_count != rules.size()) {
+			_valid_rules.clear();
+			_valid_rules_rule_count = rules.size();
+		}
+
+		auto it = _valid_rules.find(key);
+		if (it != _valid_rules.end()) {
+			_valid_rules_hits++;
+			return it->second;
+		}
+		_valid_rules_misses++;
+	}
+
+	// Generate all unified rules
+	RuleTypedSubstitutionMap unified;
 	for (RulePtr rule : rules) {
+		// Unification can be costly, stop as soon as cancelled. The
+		// partial result must not be cached.
+		if (_cancellation and _cancellation->is_cancelled())
+			return unified;
+
 		// For now ignore meta rules as they are forwardly applied in
 		// expand_bit()
 		if (rule->is_meta())
 			continue;
 
-		// Get the leaf vardecl from fcs. We don't want to filter it
-		// because otherwise the typed substitution obtained may miss some
-		// variables in the FCS declaration that needs to be substituted
-		// during expension.
-		Handle vardecl;
-		if (andbit.fcs)
-			vardecl = BindLinkCast(andbit.fcs)->get_vardecl();
+		RuleTypedSubstitutionMap rule_unified = rule->unify_target(leaf, vardecl);
+		unified.insert(rule_unified.begin(), rule_unified.end());
+	}
+
+	std::lock_guard<std::mutex> lock(_valid_rules_mutex);
+	_valid_rules.emplace(key, unified);
+	return unified;
+}
 
-		RuleTypedSubstitutionMap unified_rules
-			= rule->unify_target(bitleaf.body, vardecl);
+void ControlPolicy::set_cancellation_token(const CancellationTokenPtr& token)
+{
+	_cancellation = token;
+}
 
-		// Only insert unexplored rules for this leaf
-		RuleTypedSubstitutionMap pos_rules;
-		for (const auto& rule : unified_rules)
-			if (not _bit.is_in(rule, bitleaf))
-				pos_rules.insert(rule);
+const ExpansionControlRulesPtr& ControlPolicy::get_expansion_control_rules() const
+{
+	return _expansion_control_rules;
+}
 
-		valid_rules.insert(pos_rules.begin(), pos_rules.end());
+void ControlPolicy::forget_activities(const HandleSeq& fcss)
+{
+	std::lock_guard<std::mutex> lock(_matching_mutex);
+	if (fcss.empty()) {
+		_activities.clear();
+		return;
 	}
-	return valid_rules;
+
+	// Activities are ordered by control rule first, thus all are
+	// visited, which is fine as evictions occur in batches
+	std::set<Handle, content_based_handle_less> forgotten(fcss.begin(),
+	                                                      fcss.end());
+	for (auto it = _activities.begin(); it != _activities.end();) {
+		if (forgotten.count(std::get<1>(it->first)))
+			it = _activities.erase(it);
+		else
+			++it;
+	}
+}
+
+unsigned long ControlPolicy::valid_rules_hits() const
+{
+	std::lock_guard<std::mutex> lock(_valid_rules_mutex);
+	return _valid_rules_hits;
+}
+
+unsigned long ControlPolicy::valid_rules_misses() const
+{
+	std::lock_guard<std::mutex> lock(_valid_rules_mutex);
+	return _valid_rules_misses;
+}
+
+double ControlPolicy::valid_rules_hit_rate() const
+{
+	std::lock_guard<std::mutex> lock(_valid_rules_mutex);
+	unsigned long lookups = _valid_rules_hits + _valid_rules_misses;
+	return lookups == 0 ? 0.0 : (double)_valid_rules_hits / lookups;
+}
+
+bool ControlPolicy::LeafKeyLess::operator()(const LeafKey& lhs,
+                                            const LeafKey& rhs) const
+{
+	content_based_handle_less less;
+	if (less(lhs.first, rhs.first)) return true;
+	if (less(rhs.first, lhs.first)) return false;
+
+	// The vardecl may be undefined
+	if (not lhs.second or not rhs.second)
+		return not lhs.second and rhs.second;
+	return less(lhs.second, rhs.second);
 }
 
 RuleSelection ControlPolicy::select_rule(const AndBIT& andbit,
                                          const BITNode& bitleaf,
-                                         const RuleTypedSubstitutionMap& inf_rules)
+                                         const RuleTypedSubstitutionMap& inf_rules,
+                                         RandGen& rng)
 {
 	// Build a mapping from rule to TV of expansion success
 	HandleTVMap success_tvs = expansion_success_tvs(andbit, bitleaf, inf_rules);
@@ -147,7 +276,10 @@ RuleSelection ControlPolicy::select_rule(const AndBIT& andbit,
 
 	// Sample an inference rule according to the distribution
 	std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
-	const RuleTypedSubstitutionPair& selected_rule = rand_element(inf_rules, dist);
+	std::unique_lock<std::mutex> lock(_sampling_mutex);
+	const RuleTypedSubstitutionPair& selected_rule =
+		*std::next(inf_rules.begin(), dist(rng));
+	lock.unlock();
 
 	// Return the selected rule and its probability of success, will
 	// be used to calculate the TV that the produce and-BIT is a
@@ -176,10 +308,7 @@ HandleTVMap ControlPolicy::expansion_success_tvs(
 		} else {
 			// Otherwise calculate the truth value of its mixture
 			// model.
-			double cpx_penalty = _ure_config.get_mm_complexity_penalty(),
-				compressiveness = _ure_config.get_mm_compressiveness();
-			success_tvs[rule] = MixtureModel(active_ctrl_rules,
-			                                 cpx_penalty, compressiveness)();
+			success_tvs[rule] = mixed_tv(active_ctrl_rules);
 		}
 	}
 
@@ -194,6 +323,42 @@ HandleTVMap ControlPolicy::expansion_success_tvs(
 	return success_tvs;
 }
 
+TruthValuePtr ControlPolicy::mixed_tv(const HandleSet& active_ctrl_rules)
+{
+	std::lock_guard<std::mutex> lock(_mixture_mutex);
+
+	// The mixture model parameters may have changed since the last
+	// chaining
+	double cpx_penalty = _ure_config.get_mm_complexity_penalty(),
+		compressiveness = _ure_config.get_mm_compressiveness();
+	if (cpx_penalty != _mixed_tvs_cpx_penalty
+	    or compressiveness != _mixed_tvs_compressiveness) {
+		_mixed_tvs.clear();
+		_mixed_tvs_cpx_penalty = cpx_penalty;
+		_mixed_tvs_compressiveness = compressiveness;
+	}
+
+	// Update the statistics of the control rules with a new TV, if
+	// any, invalidating the mixed TVs
+	for (const Handle& ctrl_rule : active_ctrl_rules) {
+		auto it = _control_rule_stats.find(ctrl_rule);
+		if (it == _control_rule_stats.end()
+		    or it->second.tv != ctrl_rule->getTruthValue()) {
+			_control_rule_stats[ctrl_rule] = MixtureModel::model_stats(ctrl_rule);
+			_mixed_tvs.clear();
+		}
+	}
+
+	auto it = _mixed_tvs.find(active_ctrl_rules);
+	if (it != _mixed_tvs.end())
+		return it->second;
+
+	TruthValuePtr tv = MixtureModel(active_ctrl_rules, cpx_penalty,
+	                                compressiveness, &_control_rule_stats)();
+	_mixed_tvs.emplace(active_ctrl_rules, tv);
+	return tv;
+}
+
 std::vector<double> ControlPolicy::rule_weights(const HandleTVMap& success_tvs,
                                                 const RuleTypedSubstitutionMap& inf_rules)
 {
@@ -236,6 +401,16 @@ std::vector<double> ControlPolicy::rule_weights(
 	return weights;
 }
 
+const HandleSet& ControlPolicy::expansion_control_rules(
+	const Handle& inf_rule_alias) const
+{
+	static const HandleSet empty;
+	if (not _expansion_control_rules)
+		return empty;
+	auto it = _expansion_control_rules->find(inf_rule_alias);
+	return it == _expansion_control_rules->end() ? empty : it->second;
+}
+
 HandleSet ControlPolicy::active_expansion_control_rules(
 	const AndBIT& andbit,
 	const BITNode& bitleaf,
@@ -246,7 +421,7 @@ HandleSet ControlPolicy::active_expansion_control_rules(
 
 	// Filter out inactive expansion control rules
 	HandleSet results;
-	for (const Handle& ctrl_rule : _expansion_control_rules[inf_rule_alias])
+	for (const Handle& ctrl_rule : expansion_control_rules(inf_rule_alias))
 		if (is_control_rule_active(andbit, bitleaf, ctrl_rule))
 			results.insert(ctrl_rule);
 
@@ -268,63 +443,97 @@ bool ControlPolicy::is_control_rule_active(const AndBIT& andbit,
                                            const BITNode& bitleaf,
                                            const Handle& ctrl_rule) const
 {
-	Handle
-		// Control rule components
-		ctrl_vardecl = ScopeLinkCast(ctrl_rule)->get_vardecl(),
-		ctrl_ante_preproof = get_antecedent_preproof(ctrl_rule),
-		ctrl_target = ctrl_ante_preproof->getOutgoingAtom(1)->getOutgoingAtom(1),
-		ctrl_expansion = get_expansion(ctrl_rule),
-		ctrl_exp_input = ctrl_expansion->getOutgoingAtom(1),
-		ctrl_andbit = ctrl_exp_input->getOutgoingAtom(0),
-		ctrl_bitleaf = ctrl_exp_input->getOutgoingAtom(1),
+	const CompiledControlRule& compiled = compile(ctrl_rule);
 
-		// Actual components
-		actl_andbit = andbit.fcs,
-		actl_andbit_vardecl = ScopeLinkCast(actl_andbit)->get_vardecl(),
-		actl_bitleaf = bitleaf.body,
-
-		// Wrap the actual andbit in a DontExecLink to match the
-		// control rule, and to guaranty that it doesn't get executed
-		// while evaluating whether it is active (i.e. whether it
-		// matches)
-		nexe_actl_andbit = createLink(DONT_EXEC_LINK, actl_andbit);
+	// 1. the control target matches the actual target
+	if (not compiled.target_match)
+		return false;
+
+	ActivityKey key(ctrl_rule, andbit.fcs, bitleaf.body);
+	{
+		std::lock_guard<std::mutex> lock(_matching_mutex);
+		auto it = _activities.find(key);
+		if (it != _activities.end())
+			return it->second;
+	}
 
 	// Make sure that the variables in the control rule and the actual
 	// andbit are disjoint
 	//
 	// TODO: should be alpha-converted to have no variable in common.
-	Variables ctrl_vars = VariableList(ctrl_vardecl).get_variables(),
-		actl_andbit_vars = VariableList(actl_andbit_vardecl).get_variables();
-	if (not is_disjoint(ctrl_vars.varset, actl_andbit_vars.varset)) {
+	const Variables& actl_andbit_vars =
+		ScopeLinkCast(andbit.fcs)->get_variables();
+	if (not is_disjoint(compiled.variables.varset, actl_andbit_vars.varset)) {
 		std::stringstream ss;
 		ss << "Not implemented yet. "
 		   << "ctrl_vars and actual_andbit_vars ctrl_vars should be disjoint, "
-		   << "but ctrl_vars = " << oc_to_string(ctrl_vars) << std::endl
+		   << "but ctrl_vars = " << oc_to_string(compiled.variables) << std::endl
 		   << "actual_andbit_vars = "
 		   << oc_to_string(actl_andbit_vars) << std::endl;
 		OC_ASSERT(false, ss.str());
 	}
 
+	// Wrap the actual andbit in a DontExecLink to match the control
+	// rule, unless the control pattern has been stripped from it
+	// already.
+	Handle actl_andbit = compiled.andbit_dont_exec ? andbit.fcs
+		: createLink(DONT_EXEC_LINK, andbit.fcs);
+
 	// Check that
-	// 1. the control target matches the actual target
 	// 2. the control andbit matches the actual andbit
 	// 3. the control bitleaf matches the actual bitleaf
-	return match(ctrl_target, _target, ctrl_vardecl)
-		and match(ctrl_andbit, nexe_actl_andbit, ctrl_vardecl)
-		and match(ctrl_bitleaf, actl_bitleaf, ctrl_vardecl);
+	bool active = match(compiled.andbit, actl_andbit, compiled.variables)
+		and match(compiled.bitleaf, bitleaf.body, compiled.variables);
+
+	std::lock_guard<std::mutex> lock(_matching_mutex);
+	_activities.emplace(key, active);
+	return active;
+}
+
+const ControlPolicy::CompiledControlRule&
+ControlPolicy::compile(const Handle& ctrl_rule) const
+{
+	std::lock_guard<std::mutex> lock(_matching_mutex);
+	auto it = _compiled_control_rules.find(ctrl_rule);
+	if (it != _compiled_control_rules.end())
+		return it->second;
+
+	Handle
+		ctrl_ante_preproof = get_antecedent_preproof(ctrl_rule),
+		ctrl_target = ctrl_ante_preproof->getOutgoingAtom(1)->getOutgoingAtom(1),
+		ctrl_expansion = get_expansion(ctrl_rule),
+		ctrl_exp_input = ctrl_expansion->getOutgoingAtom(1),
+		ctrl_andbit = ctrl_exp_input->getOutgoingAtom(0),
+		ctrl_bitleaf = ctrl_exp_input->getOutgoingAtom(1);
+
+	CompiledControlRule compiled;
+	compiled.variables = ScopeLinkCast(ctrl_rule)->get_variables();
+	compiled.andbit_dont_exec = ctrl_andbit->get_type() == DONT_EXEC_LINK;
+	compiled.andbit = compiled.andbit_dont_exec ?
+		ctrl_andbit->getOutgoingAtom(0) : ctrl_andbit;
+	compiled.bitleaf = ctrl_bitleaf;
+	compiled.target_match = match(ctrl_target, _target, compiled.variables);
+
+	return _compiled_control_rules.emplace(ctrl_rule, compiled).first->second;
 }
 
 bool ControlPolicy::match(const Handle& pattern, const Handle& term,
-                          const Handle& vardecl) const
+                          const Variables& variables) const
 {
-	AtomSpace tmp_as;
-	Handle rewrite = tmp_as.add_node(CONCEPT_NODE, "dummy"),
-		impl = tmp_as.add_link(IMPLICATION_SCOPE_LINK,
-		                       vardecl, pattern, rewrite),
-		tmp_term = tmp_as.add_atom(term),
-		result = HandleCast(MapLink(impl, tmp_term).execute(&tmp_as, false));
+	// The term has no declared variables, thus is treated as grounded
+	Unify unify(pattern, term, variables, Variables());
+	return unify().is_satisfiable();
+}
 
-	return (SET_LINK != result->get_type()) or (result->get_arity() != 0);
+bool ControlPolicy::ActivityKeyLess::operator()(const ActivityKey& lhs,
+                                                const ActivityKey& rhs) const
+{
+	content_based_handle_less less;
+	if (less(std::get<0>(lhs), std::get<0>(rhs))) return true;
+	if (less(std::get<0>(rhs), std::get<0>(lhs))) return false;
+	if (less(std::get<1>(lhs), std::get<1>(rhs))) return true;
+	if (less(std::get<1>(rhs), std::get<1>(lhs))) return false;
+	return less(std::get<2>(lhs), std::get<2>(rhs));
 }
 
 Handle ControlPolicy::get_antecedent_preproof(const Handle& ctrl_rule) const
@@ -23,11 +23,17 @@
 #ifndef _OPENCOG_CONTROLPOLICY_H_
 #define _OPENCOG_CONTROLPOLICY_H_
 
+#include <mutex>
+#include <tuple>
+
 #include <opencog/atomspace/AtomSpace.h>
+#include <opencog/atoms/core/Variables.h>
 
 #include "BIT.h"
 #include "../UREConfig.h"
 #include "../Rule.h"
+#include "../MixtureModel.h"
+#include "../CancellationToken.h"
 
 class ControlPolicyUTest;
 
@@ -44,12 +50,24 @@ typedef std::map<Handle, TruthValuePtr> HandleTVMap;
 // TODO: maybe wrap that in a class, and use it in foward chainer
 typedef std::pair<RuleTypedSubstitutionPair, double> RuleSelection;
 
+// Map each inference rule alias to the set of expansion control rules
+// involving it. It does not change once fetched, thus can be shared
+// by the policies of backward chainers running over the same rule
+// base and control atomspace, see BatchBackwardChainer.
+typedef std::map<Handle, HandleSet> ExpansionControlRules;
+typedef std::shared_ptr<const ExpansionControlRules> ExpansionControlRulesPtr;
+
 class ControlPolicy
 {
 	friend class ::ControlPolicyUTest;
 public:
+	/**
+	 * If exp_ctrl_rules is provided, the expansion control rules are
+	 * not fetched from control_as, see get_expansion_control_rules.
+	 */
 	ControlPolicy(const UREConfig& ure_config, const BIT& bit,
-	              const Handle& target, AtomSpace* control_as=nullptr);
+	              const Handle& target, AtomSpace* control_as=nullptr,
+	              const ExpansionControlRulesPtr& exp_ctrl_rules=nullptr);
 	~ControlPolicy();
 
 	const std::string preproof_predicate_name = "URE:BC:preproof-of";
@@ -73,7 +91,16 @@ public:
 	 * The andbit and bitleaf are not const because if the rules are
 	 * exhausted it will set its exhausted flag to false.
 	 */
-	RuleSelection select_rule(AndBIT& andbit, BITNode& bitleaf);
+	RuleSelection select_rule(AndBIT& andbit, BITNode& bitleaf,
+	                          RandGen& rng=randGen());
+
+	/**
+	 * Return all valid inference rules, in the sense that they may
+	 * possibly be used to infer the target, and have not expanded
+	 * bitleaf yet.
+	 */
+	RuleTypedSubstitutionMap get_valid_rules(const AndBIT& andbit,
+	                                         const BITNode& bitleaf);
 
 	/**
 	 * Return the set of rule aliases (i,e. DefineSchema pointing to
@@ -81,6 +108,44 @@ public:
 	 */
 	static HandleSet rule_aliases(const RuleTypedSubstitutionMap& rules);
 
+	/**
+	 * Number of hits and misses of the valid rules cache, and the
+	 * ratio of hits over lookups, see get_valid_rules.
+	 */
+	unsigned long valid_rules_hits() const;
+	unsigned long valid_rules_misses() const;
+	double valid_rules_hit_rate() const;
+
+	/**
+	 * Update the TV of the given rule alias, as well as its default
+	 * TV, according to whether an expansion by that rule has led to
+	 * a proof, see Rule::update_tv.
+	 *
+	 * Must not be called while rules are being selected.
+	 */
+	void update_rule_tv(const Handle& rule_alias, bool success);
+
+	/**
+	 * Set the token of the backward chainer, so that the search of
+	 * the valid rules stops as soon as it is cancelled.
+	 */
+	void set_cancellation_token(const CancellationTokenPtr& token);
+
+	/**
+	 * Return the expansion control rules fetched from control_as,
+	 * so that they can be passed to other policies, or nullptr if no
+	 * control_as has been provided.
+	 */
+	const ExpansionControlRulesPtr& get_expansion_control_rules() const;
+
+	/**
+	 * Forget the memoized activities of the control rules over the
+	 * given and-BITs, for instance as they have been evicted from
+	 * the BIT, or over all and-BITs if none is given, see
+	 * is_control_rule_active.
+	 */
+	void forget_activities(const HandleSeq& fcss=HandleSeq());
+
 private:
 	// Reference to URE configuration
 	const UREConfig& _ure_config;
@@ -111,15 +176,95 @@ private:
 	AtomSpace* _query_as;
 
 	// Map each action (inference rule expansion) to the set of
-	// control rules involving it.
-	std::map<Handle, HandleSet> _expansion_control_rules;
+	// control rules involving it. Read by concurrent expansion
+	// threads, thus only looked up, see expansion_control_rules.
+	ExpansionControlRulesPtr _expansion_control_rules;
+
+	// Protect the random generator as rules may be selected by
+	// several expansion threads at once
+	std::mutex _sampling_mutex;
+
+	// Expansion control rule compiled into what is needed to tell
+	// whether it is active, see is_control_rule_active.
+	struct CompiledControlRule
+	{
+		// Variables of the control rule
+		Variables variables;
+
+		// Pattern of the input and-BIT of the expansion, stripped
+		// from its DontExecLink, if any (see andbit_dont_exec)
+		Handle andbit;
+		bool andbit_dont_exec;
+
+		// Pattern of the BIT-leaf of the expansion
+		Handle bitleaf;
+
+		// Whether the control rule target matches the actual target,
+		// which does not change during the lifetime of the policy
+		bool target_match;
+	};
+	mutable std::map<Handle, CompiledControlRule> _compiled_control_rules;
+
+	// Memoized activity of control rules, per (control rule, and-BIT
+	// FCS, BIT-leaf body). FCSs and leaves are compared by content as
+	// they do not belong to any atomspace, see AndBIT::fcs. Entries
+	// are forgotten as their and-BITs are evicted, and all of them at
+	// the end of chaining, see forget_activities.
+	typedef std::tuple<Handle, Handle, Handle> ActivityKey;
+	struct ActivityKeyLess
+	{
+		bool operator()(const ActivityKey& lhs, const ActivityKey& rhs) const;
+	};
+	mutable std::map<ActivityKey, bool, ActivityKeyLess> _activities;
+
+	// Protect _compiled_control_rules and _activities
+	mutable std::mutex _matching_mutex;
+
+	// Rules unified with a BIT-leaf, per (leaf body, FCS vardecl),
+	// before being filtered against the rules that have already
+	// expanded it. Cleared whenever the rule set changes (due to
+	// meta-rule expansion), which is detected by its size.
+	typedef std::pair<Handle, Handle> LeafKey;
+	struct LeafKeyLess
+	{
+		bool operator()(const LeafKey& lhs, const LeafKey& rhs) const;
+	};
+	std::map<LeafKey, RuleTypedSubstitutionMap, LeafKeyLess> _valid_rules;
+	size_t _valid_rules_rule_count;
+	unsigned long _valid_rules_hits;
+	unsigned long _valid_rules_misses;
+
+	// Protect _valid_rules and its counters
+	mutable std::mutex _valid_rules_mutex;
+
+	// Token of the backward chainer, if any
+	CancellationTokenPtr _cancellation;
+
+	// Statistics of the control rules used by the mixture model,
+	// calculated once per control rule TV
+	MixtureModel::ModelStatsMap _control_rule_stats;
+
+	// Mixed TVs per set of active control rules. Cleared whenever the
+	// TV of a control rule, or a mixture model parameter, changes.
+	std::map<HandleSet, TruthValuePtr> _mixed_tvs;
+	double _mixed_tvs_cpx_penalty;
+	double _mixed_tvs_compressiveness;
+
+	// Protect _control_rule_stats and _mixed_tvs
+	std::mutex _mixture_mutex;
 
 	/**
-	 * Return all valid inference rules, in the sense that they may
-	 * possibly be used to infer the target.
+	 * Return the TV of the mixture model of the given active control
+	 * rules, reusing it if already calculated.
 	 */
-	RuleTypedSubstitutionMap get_valid_rules(const AndBIT& andbit,
-	                                         const BITNode& bitleaf);
+	TruthValuePtr mixed_tv(const HandleSet& active_ctrl_rules);
+
+	/**
+	 * Return all rules unified with the given BIT-leaf, whether they
+	 * have already expanded it or not, computing them if not cached.
+	 */
+	RuleTypedSubstitutionMap unified_rules(const Handle& leaf,
+	                                       const Handle& vardecl);
 
 	/**
 	 * Select an inference rule for expansion amongst a set of valid
@@ -127,7 +272,8 @@ private:
 	 */
 	RuleSelection select_rule(const AndBIT& andbit,
 	                          const BITNode& bitleaf,
-	                          const RuleTypedSubstitutionMap& rules);
+	                          const RuleTypedSubstitutionMap& rules,
+	                          RandGen& rng);
 
 	/**
 	 * Return the conditional TVs that a given rule expands a supposed
@@ -165,6 +311,13 @@ private:
 	 */
 	HandleCounter default_alias_weights(const RuleTypedSubstitutionMap& rules) const;
 
+	/**
+	 * Return the expansion control rules concerning the given
+	 * inference rule, the empty set if there are none, without ever
+	 * inserting in _expansion_control_rules.
+	 */
+	const HandleSet& expansion_control_rules(const Handle& inf_rule_alias) const;
+
 	/**
 	 * Get all active expansion control rules concerning the given
 	 * inference rule.
@@ -191,13 +344,19 @@ private:
 	                            const Handle& ctrl_rule) const;
 
 	/**
-	 * Given a pattern, with an optional variable declaration vardecl,
-	 * and a term, check whether the pattern matches the term. This is
-	 * different than unification in the sense that term is always
-	 * treated as grounded term.
+	 * Return the compiled version of the given control rule,
+	 * compiling it if not already.
+	 */
+	const CompiledControlRule& compile(const Handle& ctrl_rule) const;
+
+	/**
+	 * Given a pattern with its variables, and a term, check whether
+	 * the pattern matches the term. This is different than
+	 * unification in the sense that term is always treated as
+	 * grounded term. No atom is created in the process.
 	 */
 	bool match(const Handle& pattern, const Handle& term,
-	           const Handle& vardecl=Handle::UNDEFINED) const;
+	           const Variables& variables) const;
 
 	/**
 	 * Given a control rule, get the antecedent part concerning
@@ -0,0 +1,120 @@
+/*
+ * FulfillmentCache.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/base/Atom.h>
+
+#include "FulfillmentCache.h"
+
+namespace opencog {
+
+FulfillmentCache::FulfillmentCache() : _capacity(0), _hits(0), _misses(0) {}
+
+bool FulfillmentCache::get(const Handle& fcs, const KBVersion& version,
+                           HandleSeq& results)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _entries.find(fcs);
+	if (it == _entries.end() or not (it->second.version == version)) {
+		_misses++;
+		return false;
+	}
+	_hits++;
+	_lru.splice(_lru.begin(), _lru, it->second.lru);
+	results = it->second.results;
+	return true;
+}
+
+void FulfillmentCache::set(const Handle& fcs, const KBVersion& version,
+                           const HandleSeq& results)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _entries.find(fcs);
+	if (it != _entries.end()) {
+		it->second.version = version;
+		it->second.results = results;
+		_lru.splice(_lru.begin(), _lru, it->second.lru);
+		return;
+	}
+	_lru.push_front(fcs);
+	_entries.emplace(fcs, Entry{version, results, _lru.begin()});
+	trim();
+}
+
+void FulfillmentCache::erase(const Handle& fcs)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _entries.find(fcs);
+	if (it == _entries.end())
+		return;
+	_lru.erase(it->second.lru);
+	_entries.erase(it);
+}
+
+void FulfillmentCache::set_capacity(size_t capacity)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_capacity = capacity;
+	trim();
+}
+
+void FulfillmentCache::trim()
+{
+	while (0 < _capacity and _capacity < _entries.size()) {
+		_entries.erase(_lru.back());
+		_lru.pop_back();
+	}
+}
+
+void FulfillmentCache::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries.clear();
+	_lru.clear();
+	_hits = 0;
+	_misses = 0;
+}
+
+size_t FulfillmentCache::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.size();
+}
+
+unsigned long FulfillmentCache::hits() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _hits;
+}
+
+unsigned long FulfillmentCache::misses() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _misses;
+}
+
+double FulfillmentCache::hit_rate() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	unsigned long lookups = _hits + _misses;
+	return lookups == 0 ? 0.0 : (double)_hits / lookups;
+}
+
+} // namespace opencog
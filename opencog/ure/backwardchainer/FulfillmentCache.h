@@ -0,0 +1,139 @@
+/*
+ * FulfillmentCache.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_FULFILLMENTCACHE_H_
+#define _OPENCOG_FULFILLMENTCACHE_H_
+
+#include <list>
+#include <map>
+#include <mutex>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog
+{
+
+/**
+ * Version of the knowledge base, as far as the backward chainer can
+ * tell. It is made of the number of atoms in the knowledge base,
+ * together with the number of fulfillments that have produced
+ * results, as running an FCS may modify the TVs of existing atoms
+ * without adding any.
+ */
+struct KBVersion
+{
+	KBVersion(size_t s=0, unsigned long u=0) : size(s), updates(u) {}
+
+	bool operator==(const KBVersion& other) const {
+		return size == other.size and updates == other.updates;
+	}
+
+	size_t size;
+	unsigned long updates;
+};
+
+/**
+ * Cache of the results of running FCSs, so that an FCS selected for
+ * fulfillment is not run again if neither it nor the knowledge base
+ * has changed since its last run.
+ *
+ * FCSs are compared by content, so that an FCS that is run again by
+ * another and-BIT with the same content still hits the cache.
+ *
+ * The entries of and-BITs evicted from the BIT are erased, and the
+ * cache may be given a capacity, beyond which the least recently
+ * used entry is dropped, so that it does not outgrow the BIT, see
+ * BackwardChainer::reduce_bit.
+ *
+ * Since the knowledge base version does not account for TV updates
+ * made outside of the backward chainer, a cache hit may return
+ * results with outdated TVs, which is why the cache is disabled by
+ * default, see URE:BC:fulfillment-cache.
+ *
+ * It is thread safe, so that it can be used by the fulfillment
+ * workers.
+ */
+class FulfillmentCache
+{
+public:
+	FulfillmentCache();
+
+	/**
+	 * If fcs has been run against the given version of the knowledge
+	 * base, then copy its results in results and return true.
+	 * Otherwise return false.
+	 */
+	bool get(const Handle& fcs, const KBVersion& version, HandleSeq& results);
+
+	/**
+	 * Record the results of running fcs against the given version of
+	 * the knowledge base.
+	 */
+	void set(const Handle& fcs, const KBVersion& version,
+	         const HandleSeq& results);
+
+	/**
+	 * Erase the entry of fcs, if any.
+	 */
+	void erase(const Handle& fcs);
+
+	/**
+	 * Set the maximum number of entries, 0 meaning unbounded, the
+	 * default. Drop the least recently used entries beyond it.
+	 */
+	void set_capacity(size_t capacity);
+
+	void clear();
+
+	size_t size() const;
+	unsigned long hits() const;
+	unsigned long misses() const;
+
+	/**
+	 * Ratio of hits over lookups, 0 if there has been no lookup.
+	 */
+	double hit_rate() const;
+
+private:
+	struct Entry
+	{
+		KBVersion version;
+		HandleSeq results;
+		std::list<Handle>::iterator lru;
+	};
+	std::map<Handle, Entry, content_based_handle_less> _entries;
+
+	// FCSs from the most to the least recently used
+	std::list<Handle> _lru;
+	size_t _capacity;
+
+	// Drop the least recently used entries beyond the capacity,
+	// assume _mutex is locked
+	void trim();
+
+	unsigned long _hits;
+	unsigned long _misses;
+
+	mutable std::mutex _mutex;
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_FULFILLMENTCACHE_H_ */
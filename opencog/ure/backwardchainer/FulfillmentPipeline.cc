@@ -0,0 +1,114 @@
+/*
+ * FulfillmentPipeline.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include "FulfillmentPipeline.h"
+
+namespace opencog {
+
+FulfillmentPipeline::FulfillmentPipeline(const Executor& executor)
+	: _executor(executor), _capacity(1), _stopping(false) {}
+
+FulfillmentPipeline::~FulfillmentPipeline()
+{
+	stop();
+}
+
+void FulfillmentPipeline::start(unsigned jobs, size_t capacity)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (not _workers.empty())
+		return;
+
+	_capacity = std::max<size_t>(capacity, 1);
+	_stopping = false;
+	for (unsigned i = 0; i < std::max(jobs, 1U); i++)
+		_workers.emplace_back(&FulfillmentPipeline::work, this);
+}
+
+bool FulfillmentPipeline::is_started() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return not _workers.empty();
+}
+
+void FulfillmentPipeline::push(const Handle& fcs)
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_not_full.wait(lock, [&]() { return _queue.size() < _capacity; });
+		_queue.push_back(fcs);
+	}
+	_not_empty.notify_one();
+}
+
+void FulfillmentPipeline::drain(Fulfillments& fulfillments)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (Fulfillment& ff : _completed)
+		fulfillments.push_back(std::move(ff));
+	_completed.clear();
+}
+
+void FulfillmentPipeline::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_workers.empty())
+			return;
+		_stopping = true;
+	}
+	_not_empty.notify_all();
+	for (std::thread& worker : _workers)
+		worker.join();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_workers.clear();
+}
+
+void FulfillmentPipeline::work()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		// Remaining FCSs are executed before stopping
+		_not_empty.wait(lock, [&]() { return not _queue.empty() or _stopping; });
+		if (_queue.empty())
+			return;
+
+		Handle fcs = _queue.front();
+		_queue.pop_front();
+		lock.unlock();
+		_not_full.notify_one();
+
+		// Wrap in a try/catch in case the pattern matcher can't
+		// handle it.
+		HandleSeq results;
+		try {
+			results = _executor(fcs);
+		} catch (...) {}
+
+		lock.lock();
+		_completed.emplace_back(fcs, std::move(results));
+	}
+}
+
+} // namespace opencog
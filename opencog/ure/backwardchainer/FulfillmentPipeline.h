@@ -0,0 +1,113 @@
+/*
+ * FulfillmentPipeline.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_FULFILLMENTPIPELINE_H_
+#define _OPENCOG_FULFILLMENTPIPELINE_H_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog
+{
+
+// An FCS and the results of its execution
+typedef std::pair<Handle, HandleSeq> Fulfillment;
+typedef std::vector<Fulfillment> Fulfillments;
+
+/**
+ * Execute FCSs in the background, so that the backward chainer can
+ * keep expanding the BIT while the FCSs of the previous expansions
+ * are being run against the knowledge base.
+ *
+ * FCSs are pushed in a bounded queue, consumed by a pool of workers.
+ * Pushing blocks while the queue is full, preventing the expansion
+ * from running too far ahead of the fulfillment.
+ *
+ * Workers only run the FCSs, the fulfillments are then collected by
+ * a single consumer (the chaining thread) with drain(), so that
+ * whatever is done with the results, such as recording them in the
+ * trace, does not require any locking.
+ */
+class FulfillmentPipeline
+{
+public:
+	// Execute an FCS and return its results
+	typedef std::function<HandleSeq(const Handle&)> Executor;
+
+	FulfillmentPipeline(const Executor& executor);
+	~FulfillmentPipeline();
+
+	/**
+	 * Launch jobs workers, with a queue of FCSs to execute holding at
+	 * most capacity FCSs. Do nothing if already started.
+	 */
+	void start(unsigned jobs, size_t capacity);
+
+	/**
+	 * Return true iff the workers have been launched.
+	 */
+	bool is_started() const;
+
+	/**
+	 * Push an FCS to execute, blocking while the queue is full.
+	 */
+	void push(const Handle& fcs);
+
+	/**
+	 * Move the fulfillments completed so far into fulfillments.
+	 */
+	void drain(Fulfillments& fulfillments);
+
+	/**
+	 * Wait for all pushed FCSs to be executed, then terminate the
+	 * workers. The completed fulfillments can still be drained.
+	 */
+	void stop();
+
+private:
+	// Pop and execute FCSs till stopped
+	void work();
+
+	Executor _executor;
+
+	std::vector<std::thread> _workers;
+	size_t _capacity;
+
+	// FCSs to execute
+	std::deque<Handle> _queue;
+
+	// Fulfillments completed but not drained yet
+	Fulfillments _completed;
+
+	bool _stopping;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _not_empty;
+	std::condition_variable _not_full;
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_FULFILLMENTPIPELINE_H_ */
@@ -0,0 +1,185 @@
+/*
+ * GoalTable.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/base/Link.h>
+#include <opencog/atoms/base/Node.h>
+#include <opencog/atoms/core/TypeUtils.h>
+
+#include "GoalTable.h"
+
+namespace opencog {
+
+GoalTable::GoalTable() : _hits(0), _misses(0) {}
+
+Handle GoalTable::goal(const Handle& leaf, const Handle& vardecl)
+{
+	// The leaf comes first so that the order of the variable
+	// declaration does not matter
+	HandleMap vars;
+	HandleSeq goal{canonical(leaf, vars)};
+	if (vardecl) {
+		Handle leaf_vardecl = filter_vardecl(vardecl, leaf);
+		if (leaf_vardecl)
+			goal.push_back(canonical(leaf_vardecl, vars));
+	}
+	return createLink(std::move(goal), LIST_LINK);
+}
+
+GoalTable::Expansion GoalTable::expansion(const Handle& leaf,
+                                          const Handle& vardecl,
+                                          const Rule& rule)
+{
+	HandleMap vars;
+	return {goal(leaf, vardecl), canonical(rule.get_rule(), vars)};
+}
+
+void GoalTable::add_expansion(const Expansion& expansion)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries[expansion.goal].expanded.insert(expansion.rule);
+}
+
+GoalTable::Consumers GoalTable::add_proof(const Expansion& expansion)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	Entry& entry = _entries[expansion.goal];
+	entry.expanded.insert(expansion.rule);
+	if (not entry.proven.insert(expansion.rule).second)
+		return Consumers();
+
+	Consumers consumers;
+	auto it = entry.consumers.find(expansion.rule);
+	if (it != entry.consumers.end()) {
+		consumers = std::move(it->second);
+		entry.consumers.erase(it);
+	}
+	return consumers;
+}
+
+void GoalTable::add_consumer(const Expansion& expansion,
+                             const Consumer& consumer)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries[expansion.goal].consumers[expansion.rule].push_back(consumer);
+}
+
+void GoalTable::set_complete(const Handle& goal)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries[goal].complete = true;
+}
+
+GoalTable::Status GoalTable::status(const Expansion& expansion)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _entries.find(expansion.goal);
+	if (it == _entries.end() or
+	    it->second.expanded.find(expansion.rule) == it->second.expanded.end()) {
+		_misses++;
+		return Status::UNKNOWN;
+	}
+	_hits++;
+	return it->second.proven.find(expansion.rule) == it->second.proven.end() ?
+		Status::EXPANDED : Status::PROVEN;
+}
+
+bool GoalTable::is_proven(const Expansion& expansion) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _entries.find(expansion.goal);
+	return it != _entries.end() and
+		it->second.proven.find(expansion.rule) != it->second.proven.end();
+}
+
+bool GoalTable::is_complete(const Handle& goal) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _entries.find(goal);
+	return it != _entries.end() and it->second.complete;
+}
+
+bool GoalTable::contains(const Handle& goal) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.find(goal) != _entries.end();
+}
+
+GoalTable::Consumers GoalTable::consumers() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	Consumers consumers;
+	for (const auto& entry : _entries)
+		for (const auto& rc : entry.second.consumers)
+			consumers.insert(consumers.end(), rc.second.begin(), rc.second.end());
+	return consumers;
+}
+
+void GoalTable::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries.clear();
+	_hits = 0;
+	_misses = 0;
+}
+
+size_t GoalTable::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.size();
+}
+
+unsigned long GoalTable::hits() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _hits;
+}
+
+unsigned long GoalTable::misses() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _misses;
+}
+
+Handle GoalTable::canonical(const Handle& h, HandleMap& vars)
+{
+	if (h->get_type() == VARIABLE_NODE) {
+		auto it = vars.find(h);
+		if (it != vars.end())
+			return it->second;
+		Handle var = createNode(VARIABLE_NODE,
+		                        "$__goal-" + std::to_string(vars.size()));
+		vars.emplace(h, var);
+		return var;
+	}
+
+	if (not h->is_link())
+		return h;
+
+	bool changed = false;
+	HandleSeq outgoings;
+	for (const Handle& out : h->getOutgoingSet()) {
+		outgoings.push_back(canonical(out, vars));
+		changed |= outgoings.back() != out;
+	}
+	return changed ? createLink(std::move(outgoings), h->get_type()) : h;
+}
+
+} // namespace opencog
@@ -0,0 +1,181 @@
+/*
+ * GoalTable.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_GOALTABLE_H_
+#define _OPENCOG_GOALTABLE_H_
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <opencog/atoms/base/Handle.h>
+
+#include "../Rule.h"
+
+namespace opencog
+{
+
+/**
+ * Table of the subgoals of the BIT, shared by all and-BITs, so that a
+ * subgoal, appearing as leaf of many and-BITs, is not searched anew
+ * in each of them (a simple form of SLG tabling).
+ *
+ * A subgoal is a leaf together with the declaration of its
+ * variables, in canonical form, that is with its variables renamed
+ * in order of appearance, so that alpha-equivalent leaves are the
+ * same subgoal. For each subgoal are recorded
+ *
+ * 1. the rules that have expanded it, in any and-BIT,
+ * 2. amongst them, the ones that have led to a proof of that
+ *    subgoal, that is that are part of an and-BIT whose FCS has
+ *    produced results,
+ * 3. the consumers of each expansion not proven yet, that is the
+ *    BIT-nodes of the same subgoal in other and-BITs that have
+ *    skipped it, waiting to be fed with its proof,
+ * 4. whether it is complete, that is all its valid rules have been
+ *    tried.
+ *
+ * Rules are canonicalized as well, as their variables are renamed
+ * at each unification.
+ *
+ * It is thread safe, so that it can be used by concurrent expansions.
+ */
+class GoalTable
+{
+public:
+	// A subgoal expanded by a rule, both in canonical form
+	struct Expansion
+	{
+		Handle goal;
+		Handle rule;
+	};
+
+	// A BIT-node that has skipped an expansion of its subgoal, and
+	// the rule, specialized to its leaf, with its typed substitution,
+	// to expand it with once that expansion is proven.
+	struct Consumer
+	{
+		Handle fcs;
+		Handle leaf;
+		Rule rule;
+		Unify::TypedSubstitution ts;
+	};
+	typedef std::vector<Consumer> Consumers;
+
+	enum class Status
+	{
+		UNKNOWN,                // Not expanded by that rule yet
+		EXPANDED,               // Expanded, but no proof so far
+		PROVEN                  // Expanded and led to a proof
+	};
+
+	GoalTable();
+
+	/**
+	 * Return the canonical subgoal of a leaf, given the variable
+	 * declaration of its FCS.
+	 */
+	static Handle goal(const Handle& leaf, const Handle& vardecl);
+
+	/**
+	 * Return the canonical expansion of a leaf by a rule.
+	 */
+	static Expansion expansion(const Handle& leaf, const Handle& vardecl,
+	                           const Rule& rule);
+
+	/**
+	 * Record that a subgoal has been expanded by a rule.
+	 */
+	void add_expansion(const Expansion& expansion);
+
+	/**
+	 * Record that an expansion has led to a proof of its subgoal.
+	 * Return its consumers, if that proof is new, so that they can be
+	 * fed with it. They are then forgotten.
+	 */
+	Consumers add_proof(const Expansion& expansion);
+
+	/**
+	 * Record that a BIT-node has skipped an expansion of its subgoal
+	 * not proven yet.
+	 */
+	void add_consumer(const Expansion& expansion, const Consumer& consumer);
+
+	/**
+	 * Record that all valid rules have expanded a subgoal.
+	 */
+	void set_complete(const Handle& goal);
+
+	/**
+	 * Return what is known about a given expansion. Lookups of
+	 * recorded expansions count as hits, others as misses.
+	 */
+	Status status(const Expansion& expansion);
+
+	/**
+	 * Like status, without counting it as hit or miss.
+	 */
+	bool is_proven(const Expansion& expansion) const;
+
+	bool is_complete(const Handle& goal) const;
+
+	/**
+	 * Return true iff the subgoal has been recorded.
+	 */
+	bool contains(const Handle& goal) const;
+
+	/**
+	 * Return the consumers of all expansions.
+	 */
+	Consumers consumers() const;
+
+	void clear();
+
+	size_t size() const;
+	unsigned long hits() const;
+	unsigned long misses() const;
+
+private:
+	// Rename the variables of h according to vars, extending it with
+	// new canonical variables in order of appearance.
+	static Handle canonical(const Handle& h, HandleMap& vars);
+
+	typedef std::set<Handle, content_based_handle_less> CanonicalRules;
+	struct Entry
+	{
+		Entry() : complete(false) {}
+
+		CanonicalRules expanded;
+		CanonicalRules proven;
+		std::map<Handle, Consumers, content_based_handle_less> consumers;
+		bool complete;
+	};
+	std::map<Handle, Entry, content_based_handle_less> _entries;
+
+	unsigned long _hits;
+	unsigned long _misses;
+
+	mutable std::mutex _mutex;
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_GOALTABLE_H_ */
@@ -31,7 +31,8 @@ const std::string TraceRecorder::andbit_predicate_name = "URE:BC:and-BIT";
 const std::string TraceRecorder::expand_andbit_schema_name = "URE:BC:expand-and-BIT";
 const std::string TraceRecorder::proof_predicate_name = "URE:BC:proof-of";
 
-TraceRecorder::TraceRecorder(AtomSpace* tr_as) : _trace_as(tr_as) {
+TraceRecorder::TraceRecorder(AtomSpace* tr_as)
+	: _trace_as(tr_as), _writer(tr_as) {
 	if (_trace_as) {
 		_target_predicate =
 			_trace_as->add_node(PREDICATE_NODE, std::move(std::string(target_predicate_name)));
@@ -44,8 +45,24 @@ TraceRecorder::TraceRecorder(AtomSpace* tr_as) : _trace_as(tr_as) {
 	}
 }
 
+void TraceRecorder::flush()
+{
+	_writer.flush();
+}
+
+void TraceRecorder::set_sampling(double sampling)
+{
+	_writer.set_sampling(sampling);
+}
+
+void TraceRecorder::set_async(bool async)
+{
+	_writer.set_async(async);
+}
+
 HandleSeqSet TraceRecorder::traces()
 {
+	flush();
 	HandleSeqSet trs;
 	for (const Handle& fcs_proof : get_fcs_proofs())
 		set_union_modify(trs, traces(fcs_proof));
@@ -76,87 +93,96 @@ HandleSeqSet TraceRecorder::traces(const Handle& fcs)
 
 void TraceRecorder::target(const Handle& target)
 {
-	add_evaluation(_target_predicate, target, TruthValue::TRUE_TV());
+	// The target is always recorded, regardless of sampling
+	if (not _writer.enabled())
+		return;
+
+	Handle pred = _target_predicate;
+	_writer.push([pred, target](AtomSpace& as) {
+			add_evaluation(as, pred, target, TruthValue::TRUE_TV()); });
 }
 
 void TraceRecorder::andbit(const AndBIT& andbit)
 {
-	add_evaluation(_andbit_predicate,
-	               dont_exec(andbit.fcs),
-	               TruthValue::TRUE_TV());
+	if (not _writer.sample(andbit.fcs))
+		return;
+
+	Handle pred = _andbit_predicate, fcs = andbit.fcs;
+	_writer.push([pred, fcs](AtomSpace& as) {
+			add_evaluation(as, pred, dont_exec(as, fcs), TruthValue::TRUE_TV()); });
 }
 
 void TraceRecorder::expansion(const Handle& andbit_fcs, const Handle& bitleaf_body,
                               const Rule& rule, const AndBIT& new_andbit)
 {
-	add_execution(_expand_andbit_schema,
-	              dont_exec(andbit_fcs), bitleaf_body,
-	              dont_exec(rule.get_alias()),
-	              dont_exec(new_andbit.fcs), TruthValue::TRUE_TV());
+	// The expansion belongs to the and-BIT it has produced. The
+	// expanded and-BIT is recorded along with it, even if not
+	// sampled itself, so that the trace can be followed back.
+	if (not _writer.sample(new_andbit.fcs))
+		return;
+
+	Handle schema = _expand_andbit_schema, alias = rule.get_alias(),
+		new_fcs = new_andbit.fcs, pred = _andbit_predicate;
+	_writer.push([schema, pred, andbit_fcs, bitleaf_body, alias, new_fcs](AtomSpace& as) {
+			add_evaluation(as, pred, dont_exec(as, andbit_fcs), TruthValue::TRUE_TV());
+			add_execution(as, schema,
+			              dont_exec(as, andbit_fcs), bitleaf_body,
+			              dont_exec(as, alias),
+			              dont_exec(as, new_fcs), TruthValue::TRUE_TV()); });
 }
 
 void TraceRecorder::proof(const Handle& andbit_fcs, const Handle& target_result)
 {
-	add_evaluation(_proof_predicate,
-	               dont_exec(andbit_fcs), target_result,
-	               target_result->getTruthValue());
+	if (not _writer.sample(andbit_fcs))
+		return;
+
+	// Take the TV now, as it may change before the event is written
+	Handle pred = _proof_predicate;
+	TruthValuePtr tv = target_result->getTruthValue();
+	_writer.push([pred, andbit_fcs, target_result, tv](AtomSpace& as) {
+			add_evaluation(as, pred, dont_exec(as, andbit_fcs), target_result, tv); });
 }
 
-Handle TraceRecorder::dont_exec(const Handle& h)
+Handle TraceRecorder::dont_exec(AtomSpace& as, const Handle& h)
 {
-	if (not _trace_as)
-		return Handle::UNDEFINED;
-
-	return _trace_as->add_link(DONT_EXEC_LINK, h);
+	return as.add_link(DONT_EXEC_LINK, h);
 }
 
-Handle TraceRecorder::add_execution(const Handle& schema,
+Handle TraceRecorder::add_execution(AtomSpace& as, const Handle& schema,
                                     const Handle& input, const Handle& output,
                                     TruthValuePtr tv)
 {
-	if (not _trace_as)
-		return Handle::UNDEFINED;
-
-	Handle execution = _trace_as->add_link(EXECUTION_LINK, schema, input, output);
+	Handle execution = as.add_link(EXECUTION_LINK, schema, input, output);
 	execution->setTruthValue(tv);
 	return execution;
 }
 
-Handle TraceRecorder::add_execution(const Handle& schema,
+Handle TraceRecorder::add_execution(AtomSpace& as, const Handle& schema,
                                     const Handle& input1,
                                     const Handle& input2,
                                     const Handle& input3,
                                     const Handle& output,
                                     TruthValuePtr tv)
 {
-	if (not _trace_as)
-		return Handle::UNDEFINED;
-
-	Handle inputs = _trace_as->add_link(LIST_LINK, input1, input2, input3);
-	return add_execution(schema, inputs, output, tv);
+	Handle inputs = as.add_link(LIST_LINK, input1, input2, input3);
+	return add_execution(as, schema, inputs, output, tv);
 }
 
-Handle TraceRecorder::add_evaluation(const Handle& predicate,
+Handle TraceRecorder::add_evaluation(AtomSpace& as, const Handle& predicate,
                                      const Handle& argument,
                                      TruthValuePtr tv)
 {
-	if (not _trace_as)
-		return Handle::UNDEFINED;
-	
-	Handle evaluation = _trace_as->add_link(EVALUATION_LINK, predicate, argument);
+	Handle evaluation = as.add_link(EVALUATION_LINK, predicate, argument);
 	evaluation->setTruthValue(tv);
 	return evaluation;
 }
 
-Handle TraceRecorder::add_evaluation(const Handle& predicate,
+Handle TraceRecorder::add_evaluation(AtomSpace& as, const Handle& predicate,
                                      const Handle& arg1, const Handle& arg2,
                                      TruthValuePtr tv)
 {
-	if (not _trace_as)
-		return Handle::UNDEFINED;
-
-	Handle arguments = _trace_as->add_link(LIST_LINK, arg1, arg2);
-	return add_evaluation(predicate, arguments, tv);
+	Handle arguments = as.add_link(LIST_LINK, arg1, arg2);
+	return add_evaluation(as, predicate, arguments, tv);
 }
 
 HandleSet TraceRecorder::get_expansion_sources(const Handle& fcs_target)
@@ -27,6 +27,7 @@
 
 #include "BIT.h"
 #include "../Rule.h"
+#include "../TraceWriter.h"
 
 namespace opencog
 {
@@ -41,6 +42,18 @@ public:
 
 	TraceRecorder(AtomSpace* tr_as);
 
+	// Block till all recorded events have been written to the trace
+	// atomspace. Traces are written in the background, see
+	// TraceWriter.
+	void flush();
+
+	// Fraction of and-BITs to record, and whether to write them in
+	// the background. All the events of a sampled and-BIT, its
+	// creation, expansion and proofs, are recorded, so that no
+	// recorded event refers to an unrecorded and-BIT.
+	void set_sampling(double sampling);
+	void set_async(bool async);
+
 	// Return the traces of fcs leading to the recorded proofs
 	HandleSeqSet traces();
 
@@ -99,6 +112,9 @@ public:
 private:
 	AtomSpace* _trace_as;
 
+	// Write the events to _trace_as
+	TraceWriter _writer;
+
 	Handle _target_predicate, _andbit_predicate, _expand_andbit_schema,
 		_proof_predicate;
 
@@ -106,7 +122,7 @@ private:
 	//
 	// DontExecLink
 	//   h
-	Handle dont_exec(const Handle& h);
+	static Handle dont_exec(AtomSpace& as, const Handle& h);
 
 	// Add
 	//
@@ -114,9 +130,9 @@ private:
 	//   <schema>
 	//   <input>
 	//   <output>
-	Handle add_execution(const Handle& schema,
-	                     const Handle& input, const Handle& output,
-	                     TruthValuePtr tv);
+	static Handle add_execution(AtomSpace& as, const Handle& schema,
+	                            const Handle& input, const Handle& output,
+	                            TruthValuePtr tv);
 
 	// Add
 	//
@@ -127,21 +143,21 @@ private:
 	//     <input2>
 	//     <input3>
 	//   <output>
-	Handle add_execution(const Handle& schema,
-	                     const Handle& input1,
-	                     const Handle& input2,
-	                     const Handle& input3,
-	                     const Handle& output,
-	                     TruthValuePtr tv);
+	static Handle add_execution(AtomSpace& as, const Handle& schema,
+	                            const Handle& input1,
+	                            const Handle& input2,
+	                            const Handle& input3,
+	                            const Handle& output,
+	                            TruthValuePtr tv);
 
 	// Add
 	//
 	// Evaluation <tv>
 	//   <predicate>
 	//   <argument>
-	Handle add_evaluation(const Handle& predicate,
-	                      const Handle& argument,
-	                      TruthValuePtr tv);
+	static Handle add_evaluation(AtomSpace& as, const Handle& predicate,
+	                             const Handle& argument,
+	                             TruthValuePtr tv);
 
 	// Add
 	//
@@ -150,9 +166,9 @@ private:
 	//   List
 	//     <arg1>
 	//     <arg2>
-	Handle add_evaluation(const Handle& predicate,
-	                      const Handle& arg1, const Handle& arg2,
-	                      TruthValuePtr tv);
+	static Handle add_evaluation(AtomSpace& as, const Handle& predicate,
+	                             const Handle& arg1, const Handle& arg2,
+	                             TruthValuePtr tv);
 
 	// Given a fcs, return all fcs that expands to this fcs target.
 	HandleSet get_expansion_sources(const Handle& fcs_target);
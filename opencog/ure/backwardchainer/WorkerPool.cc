@@ -0,0 +1,110 @@
+/*
+ * WorkerPool.cc
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "WorkerPool.h"
+#include "../URELogger.h"
+
+namespace opencog {
+
+WorkerPool::WorkerPool() : _running(0), _stopping(false) {}
+
+WorkerPool::~WorkerPool()
+{
+	stop();
+}
+
+void WorkerPool::start(unsigned jobs)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (not _workers.empty())
+		return;
+
+	_stopping = false;
+	for (unsigned i = 0; i < jobs; i++)
+		_workers.emplace_back(&WorkerPool::work, this);
+}
+
+bool WorkerPool::is_started() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return not _workers.empty();
+}
+
+void WorkerPool::run(std::vector<Task>& tasks)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (Task& task : tasks)
+		_queue.push_back(std::move(task));
+	tasks.clear();
+	_not_empty.notify_all();
+
+	// Take part, then wait for the tasks taken by the workers
+	while (not _queue.empty())
+		run_front(lock);
+	_done.wait(lock, [&]() { return _running == 0; });
+}
+
+void WorkerPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_workers.empty())
+			return;
+		_stopping = true;
+	}
+	_not_empty.notify_all();
+	for (std::thread& worker : _workers)
+		worker.join();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_workers.clear();
+}
+
+void WorkerPool::work()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_not_empty.wait(lock, [&]() { return not _queue.empty() or _stopping; });
+		if (_queue.empty())
+			return;
+		run_front(lock);
+	}
+}
+
+void WorkerPool::run_front(std::unique_lock<std::mutex>& lock)
+{
+	Task task = std::move(_queue.front());
+	_queue.pop_front();
+	_running++;
+	lock.unlock();
+
+	try {
+		task();
+	} catch (const std::exception& e) {
+		ure_logger().warn() << "Task failed: " << e.what();
+	}
+
+	lock.lock();
+	if (--_running == 0 and _queue.empty())
+		_done.notify_all();
+}
+
+} // namespace opencog
@@ -0,0 +1,96 @@
+/*
+ * WorkerPool.h
+ *
+ * Copyright (C) 2026 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_WORKERPOOL_H_
+#define _OPENCOG_WORKERPOOL_H_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+namespace opencog
+{
+
+/**
+ * Persistent pool of workers running batches of tasks, so that the
+ * backward chainer does not create and join threads at every
+ * multithreaded expansion, see BackwardChainer::expand_bit_multithread.
+ *
+ * The thread submitting a batch takes part in running it, so that a
+ * pool of n workers runs batches n+1 tasks at a time.
+ */
+class WorkerPool
+{
+public:
+	typedef std::function<void()> Task;
+
+	WorkerPool();
+	~WorkerPool();
+
+	/**
+	 * Launch jobs workers. Do nothing if already started.
+	 */
+	void start(unsigned jobs);
+
+	/**
+	 * Return true iff the workers have been launched.
+	 */
+	bool is_started() const;
+
+	/**
+	 * Run the given tasks, with the help of the workers if started,
+	 * and return once they are all done.
+	 */
+	void run(std::vector<Task>& tasks);
+
+	/**
+	 * Terminate the workers.
+	 */
+	void stop();
+
+private:
+	// Pop and run tasks till stopped
+	void work();
+
+	// Run a task popped from the queue, assume _mutex is locked by
+	// lock, and unlock it while running the task.
+	void run_front(std::unique_lock<std::mutex>& lock);
+
+	std::vector<std::thread> _workers;
+
+	// Tasks to run
+	std::deque<Task> _queue;
+
+	// Number of tasks popped but not done yet
+	size_t _running;
+
+	bool _stopping;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _not_empty;
+	std::condition_variable _done;
+};
+
+} // namespace opencog
+
+#endif /* _OPENCOG_WORKERPOOL_H_ */
@@ -26,31 +26,154 @@
 
 using namespace opencog;
 
-void FCStat::add_inference_record(unsigned iteration, Handle source,
-                                  const Rule& rule,
-                                  const HandleSet& product)
+HandleSet FCStat::add_inference_record(unsigned iteration, Handle source,
+                                       const Rule& rule,
+                                       const HandleSet& product)
 {
+	HandleSet new_products;
 	{
 		std::lock_guard<std::mutex> lock(_whole_mutex);
-		_inf_rec.emplace_back(source, rule, product);
+		for (const Handle& h : product)
+			if (_all_products.insert(h).second)
+				new_products.insert(h);
+		if (not _results_only) {
+			unsigned sid = intern(source, _sources, _source_ids);
+			unsigned rid = intern(rule.get_alias(), _rules, _rule_ids);
+			_inf_rec.emplace_back(sid, rid, iteration,
+			                      _products.size(), product.size());
+			_products.insert(_products.end(), product.begin(), product.end());
+		}
 	}
 
-	if (_trace_as and not product.empty()) {
+	if (not product.empty() and _writer.sample()) {
 		Handle schema = rule.get_alias();
-		Handle i = _trace_as->add_node(NUMBER_NODE, std::to_string(iteration + 1));
-		Handle inputs = _trace_as->add_link(LIST_LINK, source, i);
-		for (const Handle& output : product) {
-			_trace_as->add_link(EXECUTION_LINK, schema, inputs, output);
-		}
+		_writer.push([schema, iteration, source, product](AtomSpace& as) {
+				Handle i = as.add_node(NUMBER_NODE, std::to_string(iteration + 1));
+				Handle inputs = as.add_link(LIST_LINK, source, i);
+				for (const Handle& output : product) {
+					as.add_link(EXECUTION_LINK, schema, inputs, output);
+				} });
 	}
+
+	return new_products;
+}
+
+void FCStat::flush()
+{
+	_writer.flush();
+}
+
+void FCStat::set_trace_sampling(double sampling)
+{
+	_writer.set_sampling(sampling);
+}
+
+void FCStat::set_trace_async(bool async)
+{
+	_writer.set_async(async);
 }
 
 HandleSet FCStat::get_all_products() const
 {
 	std::lock_guard<std::mutex> lock(_whole_mutex);
-	HandleSet all;
-	for(const auto& ir : _inf_rec)
-		all.insert(ir.product.begin(),ir.product.end());
+	return _all_products;
+}
+
+size_t FCStat::products_size() const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	return _all_products.size();
+}
+
+void FCStat::set_results_only(bool results_only)
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	_results_only = results_only;
+}
+
+bool FCStat::is_results_only() const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	return _results_only;
+}
+
+std::vector<InferenceRecord> FCStat::get_inference_records() const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	return _inf_rec;
+}
+
+Handle FCStat::get_source(const InferenceRecord& ir) const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	return _sources[ir.source_id];
+}
+
+Handle FCStat::get_rule_alias(const InferenceRecord& ir) const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	return _rules[ir.rule_id];
+}
+
+HandleSeq FCStat::get_products(const InferenceRecord& ir) const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	auto begin = std::next(_products.begin(), ir.product_begin);
+	return HandleSeq(begin, std::next(begin, ir.product_size));
+}
 
-	return all;
+void FCStat::save(RuleBaseWriter& writer) const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	writer.put_uint(_all_products.size());
+	for (const Handle& product : _all_products)
+		writer.put_atom(product);
+
+	writer.put_uint(_inf_rec.size());
+	for (const InferenceRecord& ir : _inf_rec) {
+		writer.put_uint(ir.iteration);
+		writer.put_atom(_sources[ir.source_id]);
+		writer.put_atom(_rules[ir.rule_id]);
+		writer.put_uint(ir.product_size);
+		for (unsigned i = 0; i < ir.product_size; i++)
+			writer.put_atom(_products[ir.product_begin + i]);
+	}
+}
+
+void FCStat::load(RuleBaseReader& reader, AtomSpace& kb_as)
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	_all_products.clear();
+	uint32_t product_count = reader.get_uint();
+	for (uint32_t i = 0; i < product_count; i++)
+		_all_products.insert(reader.get_atom(kb_as));
+
+	_inf_rec.clear();
+	_sources.clear();
+	_source_ids.clear();
+	_rules.clear();
+	_rule_ids.clear();
+	_products.clear();
+	uint32_t record_count = reader.get_uint();
+	for (uint32_t i = 0; i < record_count; i++) {
+		unsigned iteration = reader.get_uint();
+		unsigned sid = intern(reader.get_atom(kb_as), _sources, _source_ids);
+		unsigned rid = intern(reader.get_atom(), _rules, _rule_ids);
+		unsigned product_size = reader.get_uint();
+		_inf_rec.emplace_back(sid, rid, iteration, _products.size(), product_size);
+		for (unsigned j = 0; j < product_size; j++)
+			_products.push_back(reader.get_atom(kb_as));
+	}
+}
+
+unsigned FCStat::intern(const Handle& h, HandleSeq& table,
+                        std::unordered_map<Handle, unsigned>& ids)
+{
+	auto it = ids.find(h);
+	if (it != ids.end())
+		return it->second;
+	unsigned id = table.size();
+	table.push_back(h);
+	ids.emplace(h, id);
+	return id;
 }
@@ -24,27 +24,44 @@
 #ifndef _OPENCOG_FCSTAT_H_
 #define _OPENCOG_FCSTAT_H_
 
-#include <map>
+#include <mutex>
+#include <unordered_map>
 
 #include <opencog/atoms/base/Handle.h>
 #include <opencog/ure/Rule.h>
+#include <opencog/ure/TraceWriter.h>
+#include <opencog/ure/RuleBaseFile.h>
 
 namespace opencog {
 
+/**
+ * Compact record of a rule application. Sources and rules are
+ * interned and referred to by ids, and products are stored as a span
+ * of a shared array, see FCStat.
+ */
 struct InferenceRecord
 {
-	const Handle hsource;
-	const Rule& rule;
-	HandleSet product;
+	unsigned source_id;
+	unsigned rule_id;
+	unsigned iteration;
+
+	// Span [product_begin, product_begin + product_size) of the
+	// shared product array
+	size_t product_begin;
+	unsigned product_size;
 
-	InferenceRecord(Handle h, const Rule& r, const HandleSet& p)
-		: hsource(h), rule(r), product(p) {}
+	InferenceRecord(unsigned sid, unsigned rid, unsigned i,
+	                size_t pb, unsigned ps)
+		: source_id(sid), rule_id(rid), iteration(i),
+		  product_begin(pb), product_size(ps) {}
 };
 
 class FCStat
 {
 public:
-	FCStat(AtomSpace* trace_as) : _trace_as(trace_as) {}
+	FCStat(AtomSpace* trace_as, bool results_only=false)
+		: _trace_as(trace_as), _writer(trace_as),
+		  _results_only(results_only) {}
 
 	/**
 	 * Record the inference step into memory, as well as in the
@@ -63,16 +80,89 @@ public:
 	 * 2. <step> is NumberNode <#iteration>
 	 * 3. <source> is the source
 	 * 4. <product> is a SetLink <p1> ... <pn> where pi are the products
+	 *
+	 * In results only mode, only the products are kept in memory.
+	 *
+	 * The trace atomspace is written in the background, see
+	 * TraceWriter, and only a sample of the records may be written
+	 * to it.
+	 *
+	 * Return the products that were not products of previous records.
 	 */
-	void add_inference_record(unsigned iteration, Handle source,
+	HandleSet add_inference_record(unsigned iteration, Handle source,
 	                          const Rule& rule, const HandleSet& product);
+
+	/**
+	 * Block till all records have been written to the trace
+	 * atomspace.
+	 */
+	void flush();
+
+	/**
+	 * Fraction of records to write to the trace atomspace, and
+	 * whether to write them in the background.
+	 */
+	void set_trace_sampling(double sampling);
+	void set_trace_async(bool async);
+
+	/**
+	 * Return the union of all products, maintained incrementally.
+	 */
 	HandleSet get_all_products() const;
-	HandleSet get_all_products();
+	size_t products_size() const;
+
+	/**
+	 * In results only mode the per-step records are not kept, only
+	 * the set of all products. Records of the trace atomspace, if any,
+	 * are unaffected.
+	 */
+	void set_results_only(bool results_only);
+	bool is_results_only() const;
+
+	/**
+	 * Access the per-step records, empty in results only mode.
+	 */
+	std::vector<InferenceRecord> get_inference_records() const;
+	Handle get_source(const InferenceRecord& ir) const;
+	Handle get_rule_alias(const InferenceRecord& ir) const;
+	HandleSeq get_products(const InferenceRecord& ir) const;
+
+	/**
+	 * Write the products and the per-step records to a checkpoint,
+	 * see ForwardChainer::save_checkpoint, or replace them by the
+	 * ones read from a checkpoint. The trace atomspace is not
+	 * involved, sources and products are copied into kb_as.
+	 */
+	void save(RuleBaseWriter& writer) const;
+	void load(RuleBaseReader& reader, AtomSpace& kb_as);
 
 private:
+	// Return the id of h in the given interning table, inserting it
+	// if missing
+	static unsigned intern(const Handle& h, HandleSeq& table,
+	                       std::unordered_map<Handle, unsigned>& ids);
+
 	std::vector<InferenceRecord> _inf_rec;
+
+	// Interned sources and rule aliases
+	HandleSeq _sources;
+	std::unordered_map<Handle, unsigned> _source_ids;
+	HandleSeq _rules;
+	std::unordered_map<Handle, unsigned> _rule_ids;
+
+	// Products of all records, laid out contiguously
+	HandleSeq _products;
+
+	// Union of all products
+	HandleSet _all_products;
+
 	AtomSpace* _trace_as;
 
+	// Write the records to _trace_as
+	TraceWriter _writer;
+
+	bool _results_only;
+
 	// TODO: subdivide in smaller and shared mutexes
 	mutable std::mutex _whole_mutex;
 };
@@ -23,9 +23,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cstdio>
 #include <future>
 #include <thread>
 #include <chrono>
+#include <limits>
 
 #include <boost/range/adaptor/reversed.hpp>
 
@@ -40,6 +42,7 @@
 
 #include "ForwardChainer.h"
 #include "../URELogger.h"
+#include "../RuleBaseCache.h"
 #include "../backwardchainer/ControlPolicy.h"
 #include "../ThompsonSampling.h"
 
@@ -54,10 +57,16 @@ ForwardChainer::ForwardChainer(AtomSpace& kb_as,
                                const HandleSeq& focus_set)
 	: _kb_as(kb_as),
 	  _rb_as(rb_as),
-	  _config(rb_as, rbs),
+	  _checkpoint_as(&kb_as),
+	  _config(*RuleBaseCache::instance().get(rb_as, rbs)),
+	  _budget(_config, kb_as),
+	  _cancellation(std::make_shared<CancellationToken>()),
+	  _started(false),
+	  _finished(false),
+	  _checkpoint_period(0),
 	  _thread_count(0),
 	  _sources(_config, source, vardecl),
-	  _fcstat(trace_as),
+	  _fcstat(trace_as, _config.get_results_only()),
 	  _srpi(true)
 {
 	init(source, vardecl, focus_set);
@@ -118,17 +127,31 @@ const UREConfig& ForwardChainer::get_config() const
 
 void ForwardChainer::do_chain()
 {
-	ure_logger().debug("Start forward chaining");
-	LAZY_URE_LOG_DEBUG << "With rule set:" << std::endl << oc_to_string(_rules);
+	run(-1);
+}
+
+bool ForwardChainer::run(int max_steps, int max_ms)
+{
+	if (_finished)
+		return true;
+
+	if (not _started)
+		start_chain();
+	else
+		ure_logger().debug() << "Resume forward chaining at iteration "
+		                     << _iteration;
 
 	// Relex2Logic uses this. TODO make a separate class to handle
 	// this robustly.
 	if(_sources.empty())
 	{
 		apply_all_rules();
-		return;
+		finish_chain();
+		return true;
 	}
 
+	_budget.start_slice(_iteration, max_steps, max_ms);
+
 	if (_srpi)
 	{
 		do_steps_srpi();
@@ -150,28 +173,192 @@ void ForwardChainer::do_chain()
 		ure_logger().set_thread_id_flag(prev_thread_id);
 	}
 
+	_budget.end_slice();
+
+	if (not termination()) {
+		ure_logger().debug() << "Suspend forward chaining at iteration "
+		                     << _iteration;
+		return false;
+	}
+
 	// Log termination messages
 	termination_log();
 	LAZY_URE_LOG_DEBUG << "Finished forward chaining with results:"
 	                   << std::endl << oc_to_string(get_results_set());
+
+	finish_chain();
+	return true;
+}
+
+bool ForwardChainer::is_finished() const
+{
+	return _finished;
+}
+
+void ForwardChainer::save_checkpoint(const std::string& filename) const
+{
+	RuleBaseWriter writer(fc_checkpoint_magic);
+	writer.put_atom(_config.get_rbs());
+	_config.save_rule_bodies(writer);
+	writer.put_uint(_iteration);
+	_sources.save(writer);
+	_source_rule_set.save(writer, _sources);
+	{
+		std::lock_guard<std::mutex> lock(_rules_mutex);
+		writer.put_uint(_rules.size());
+		for (const RulePtr& rule : _rules) {
+			writer.put_atom(rule->get_alias());
+			writer.put_tv(rule->get_tv());
+		}
+	}
+	_fcstat.save(writer);
+
+	// Rename is atomic, a previous checkpoint is thus either kept
+	// intact or replaced by a complete one.
+	std::string tmp = filename + ".tmp";
+	writer.write(tmp);
+	if (std::rename(tmp.c_str(), filename.c_str()) != 0)
+		throw RuntimeException(TRACE_INFO,
+			"ForwardChainer - cannot rename %s to %s",
+			tmp.c_str(), filename.c_str());
+
+	ure_logger().debug() << "Saved forward chaining checkpoint to "
+	                     << filename << " at iteration " << _iteration;
+}
+
+void ForwardChainer::load_checkpoint(const std::string& filename)
+{
+	if (_started)
+		throw RuntimeException(TRACE_INFO,
+			"ForwardChainer - cannot load a checkpoint once chaining "
+			"has started");
+
+	// The atom table, including the specialized rules, is loaded in
+	// the checkpoint atomspace so that they do not pollute the
+	// knowledge base. Sources and products are then copied into it.
+	RuleBaseReader reader(_checkpoint_as, filename, fc_checkpoint_magic);
+
+	Handle rbs = reader.get_atom();
+	if (rbs->get_name() != _config.get_rbs()->get_name())
+		throw RuntimeException(TRACE_INFO,
+			"ForwardChainer - checkpoint %s is of rule base %s, not %s",
+			filename.c_str(), rbs->get_name().c_str(),
+			_config.get_rbs()->get_name().c_str());
+	if (not _config.same_rule_bodies(reader))
+		throw RuntimeException(TRACE_INFO,
+			"ForwardChainer - checkpoint %s is of other rules than "
+			"those of rule base %s", filename.c_str(),
+			rbs->get_name().c_str());
+
+	_iteration = reader.get_uint();
+
+	// Meta rules may have been tried by the checkpointed chaining
+	expand_meta_rules("");
+
+	{
+		std::lock_guard<std::mutex> lock(_rules_mutex);
+		_sources.load(reader, _rules, _kb_as);
+	}
+	_source_rule_set.load(reader, _sources);
+
+	uint32_t rule_count = reader.get_uint();
+	for (uint32_t i = 0; i < rule_count; i++) {
+		Handle alias = reader.get_atom();
+		TruthValuePtr tv = reader.get_tv();
+		std::lock_guard<std::mutex> lock(_rules_mutex);
+		for (const RulePtr& rule : _rules)
+			if (rule->get_name() == alias->get_name())
+				rule->set_tv(tv);
+	}
+	_fcstat.load(reader, _kb_as);
+
+	if (_search_focus_set)
+		for (const SourcePtr& src : _sources.sources)
+			_focus_set_as.add_atom(src->body);
+
+	ure_logger().debug() << "Loaded forward chaining checkpoint from "
+	                     << filename << " at iteration " << _iteration;
+}
+
+void ForwardChainer::set_checkpoint(const std::string& filename, int period)
+{
+	_checkpoint_file = filename;
+	_checkpoint_period = period;
+}
+
+void ForwardChainer::periodic_checkpoint()
+{
+	if (0 < _checkpoint_period and _iteration % _checkpoint_period == 0)
+		save_checkpoint(_checkpoint_file);
+}
+
+void ForwardChainer::start_chain()
+{
+	ure_logger().debug("Start forward chaining");
+	LAZY_URE_LOG_DEBUG << "With rule set:" << std::endl << oc_to_string(_rules);
+
+	// Budgets are measured from the start of chaining
+	_budget.start();
+
+	// The configuration may have changed since construction
+	_fcstat.set_results_only(_config.get_results_only());
+	_fcstat.set_trace_sampling(_config.get_trace_sampling());
+	_fcstat.set_trace_async(_config.get_trace_async());
+
+	_started = true;
+}
+
+void ForwardChainer::finish_chain()
+{
+	save_rule_tvs();
+
+	// Make sure the trace atomspace is complete
+	_fcstat.flush();
+
+	// Let the consumers know that no more results are coming
+	_result_stream.close();
+
+	_finished = true;
 }
 
 void ForwardChainer::do_steps_singlethread()
 {
-	while (not termination()) do_step(_iteration++);
+	while (not termination() and not _budget.slice_exceeded(_iteration)) {
+		do_step(_iteration++);
+		periodic_checkpoint();
+	}
 }
 
 // TODO: if creating/destroying threads is too expensive, use a thread
 // pool (see boost::asio::thread_pool).
 void ForwardChainer::do_steps_multithread()
+{
+	// Steps are run in rounds ending at the checkpoint iterations, if
+	// any, so that checkpoints are saved once all steps are over.
+	while (not termination() and not _budget.slice_exceeded(_iteration)) {
+		int round_end = std::numeric_limits<int>::max();
+		if (0 < _checkpoint_period)
+			round_end = (_iteration / _checkpoint_period + 1)
+				* _checkpoint_period;
+
+		do_steps_multithread(round_end);
+
+		// Concurrent steps may have gone slightly past the end of
+		// the round
+		if (round_end <= _iteration)
+			save_checkpoint(_checkpoint_file);
+	}
+}
+
+void ForwardChainer::do_steps_multithread(int round_end)
 {
 	// Create a pool of iterations
 	opencog::pool<int> itrpool;
 
 	// Run steps in parallel
-	while (not termination())
+	while (not termination() and not _budget.slice_exceeded(_iteration))
 	{
-		if (_thread_count < _config.get_jobs())
+		if (_thread_count < _config.get_jobs() and _iteration < round_end)
 			itrpool.give_back(_iteration++);
 
 		int local_iteration = itrpool.borrow();
@@ -183,7 +370,10 @@ void ForwardChainer::do_steps_multithread()
 		_thread_count++;
 		auto do_step_manage = [=,&itrpool]() {
 			do_step(local_iteration);
-			itrpool.give_back(termination() ? -1 : _iteration++);
+			itrpool.give_back(termination() or
+			                  _budget.slice_exceeded(_iteration) or
+			                  round_end <= _iteration ?
+			                  -1 : _iteration++);
 			_thread_count--; };
 		auto thrd = std::thread(do_step_manage);
 		thrd.detach();
@@ -196,7 +386,10 @@ void ForwardChainer::do_steps_multithread()
 
 void ForwardChainer::do_steps_srpi()
 {
-	while (not termination()) do_step_srpi(_iteration++);
+	while (not termination() and not _budget.slice_exceeded(_iteration)) {
+		do_step_srpi(_iteration++);
+		periodic_checkpoint();
+	}
 }
 
 void ForwardChainer::do_step(int iteration)
@@ -224,7 +417,7 @@ void ForwardChainer::do_step(int iteration)
 	RuleProbabilityPair rule_prob = select_rule(*source, msgprfx);
 	RulePtr rule = rule_prob.first;
 	double prob(rule_prob.second);
-	if (not rule->is_valid()) {
+	if (not rule or not rule->is_valid()) {
 		ure_logger().debug() << msgprfx << "No selected rule, abort iteration";
 		return;
 	} else {
@@ -244,7 +437,7 @@ void ForwardChainer::do_step(int iteration)
 		source->set_rule_exhausted(rule);
 
 		// Save trace and results
-		_fcstat.add_inference_record(iteration, source->body, *rule, products);
+		record_inference(iteration, source->body, *rule, products);
 	} else {
 		LAZY_URE_LOG_DEBUG << msgprfx << "Rule " << rule->to_short_string()
 		                   << " is probably being applied on source "
@@ -295,8 +488,7 @@ void ForwardChainer::do_step_srpi(int iteration)
 		slc_sr.source->set_rule_exhausted(slc_sr.rule);
 
 		// Save trace and results
-		_fcstat.add_inference_record(iteration, slc_sr.source->body,
-		                             *slc_sr.rule, products);
+		record_inference(iteration, slc_sr.source->body, *slc_sr.rule, products);
 	} else {
 		LAZY_URE_LOG_DEBUG << msgprfx
 		                   << "Failed to select a source rule pair, "
@@ -308,8 +500,12 @@ bool ForwardChainer::termination()
 {
 	bool terminate = false;
 
+	// Terminate if cancelled from outside
+	if (is_cancelled()) {
+		terminate = true;
+	}
 	// Terminate if all source rule pairs have been tried
-	if (_sources.is_exhausted() and _source_rule_set.empty()) {
+	else if (_sources.is_exhausted() and _source_rule_set.empty()) {
 		terminate = true;
 	}
 	// Terminate if max iterations has been reached
@@ -317,16 +513,49 @@ bool ForwardChainer::termination()
 	         _config.get_maximum_iterations() <= _iteration) {
 		terminate = true;
 	}
+	// Terminate if time, atoms created or memory budget is exceeded
+	else {
+		std::string msg;
+		terminate = _budget.exceeded(msg);
+	}
 
 	return terminate;
 }
 
+void ForwardChainer::cancel()
+{
+	_cancellation->cancel();
+}
+
+bool ForwardChainer::is_cancelled() const
+{
+	return _cancellation->is_cancelled();
+}
+
+void ForwardChainer::set_cancellation_token(const CancellationTokenPtr& token)
+{
+	_cancellation = token;
+}
+
+const CancellationTokenPtr& ForwardChainer::get_cancellation_token() const
+{
+	return _cancellation;
+}
+
+int ForwardChainer::get_iteration() const
+{
+	return _iteration;
+}
+
 void ForwardChainer::termination_log()
 {
 	std::string msg;
 
+	if (is_cancelled()) {
+		msg = "cancelled";
+	}
 	// Terminate if all sources have been tried
-	if (_sources.is_exhausted() and _source_rule_set.empty()) {
+	else if (_sources.is_exhausted() and _source_rule_set.empty()) {
 		msg = "all source rule pairs have been exhausted";
 	}
 	// Terminate if max iterations has been reached
@@ -334,6 +563,10 @@ void ForwardChainer::termination_log()
 	         _config.get_maximum_iterations() <= _iteration) {
 		msg = "reach maximum number of iterations";
 	}
+	// Terminate if time, atoms created or memory budget is exceeded
+	else {
+		_budget.exceeded(msg);
+	}
 
 	ure_logger().debug() << "Terminate: " << msg;
 }
@@ -348,9 +581,9 @@ void ForwardChainer::apply_all_rules()
 		HandleSet uhs = apply_rule(*rule);
 
 		// Update
-		_fcstat.add_inference_record(_iteration,
-		                             _kb_as.add_node(CONCEPT_NODE, "dummy-source"),
-		                             *rule, uhs);
+		record_inference(_iteration,
+		                 _kb_as.add_node(CONCEPT_NODE, "dummy-source"),
+		                 *rule, uhs);
 	}
 }
 
@@ -366,6 +599,11 @@ HandleSet ForwardChainer::get_results_set() const
 	return _fcstat.get_all_products();
 }
 
+ResultStream& ForwardChainer::get_result_stream()
+{
+	return _result_stream;
+}
+
 SourcePtr ForwardChainer::select_source(const std::string& msgprfx)
 {
 	// TODO: refine mutex
@@ -436,6 +674,13 @@ SourceRule ForwardChainer::mk_source_rule(const std::string& msgprfx)
 
 	const RuleSet valid_rules = get_valid_rules(*source);
 
+	// If cancelled the valid rules may be partial, do not select
+	// amongst them, and above all do not mark the source as exhausted.
+	if (is_cancelled()) {
+		LAZY_URE_LOG_DEBUG << msgprfx << "Cancelled, abort source rule pair";
+		return SourceRule();
+	}
+
 	// Log valid rules
 	if (ure_logger().is_debug_enabled()) {
 		std::stringstream ss;
@@ -524,6 +769,10 @@ RuleSet ForwardChainer::get_valid_rules(const Source& source)
 	// Generate all valid rules
 	RuleSet valid_rules;
 	for (const RulePtr& rule : _rules) {
+		// Unification can be costly, stop as soon as cancelled
+		if (is_cancelled())
+			break;
+
 		// For now ignore meta rules as they are instantiated in
 		// do_step()
 		if (rule->is_meta())
@@ -569,6 +818,12 @@ RuleProbabilityPair ForwardChainer::select_rule(Source& source,
 {
 	const RuleSet valid_rules = get_valid_rules(source);
 
+	// If cancelled the valid rules may be partial, see mk_source_rule
+	if (is_cancelled()) {
+		LAZY_URE_LOG_DEBUG << msgprfx << "Cancelled, abort rule selection";
+		return RuleProbabilityPair{nullptr, 0.0};
+	}
+
 	// Log valid rules
 	if (ure_logger().is_debug_enabled()) {
 		std::stringstream ss;
@@ -670,6 +925,41 @@ HandleSet ForwardChainer::apply_rule(const SourceRule& sr)
 	return apply_rule(*sr.rule);
 }
 
+void ForwardChainer::record_inference(int iteration, const Handle& source,
+                                      const Rule& rule,
+                                      const HandleSet& products)
+{
+	HandleSet new_products =
+		_fcstat.add_inference_record(iteration, source, rule, products);
+	_result_stream.emit(iteration + 1, rule.get_alias(), source, new_products);
+
+	if (_config.get_rule_tv_learning())
+		update_rule_tv(rule, products);
+}
+
+void ForwardChainer::update_rule_tv(const Rule& rule, const HandleSet& products)
+{
+	// The application is deemed successful if it has produced
+	// anything. All rules of the same alias, including the
+	// specializations of the selected rule, share that TV.
+	std::lock_guard<std::mutex> lock(_rules_mutex);
+	bool success = not products.empty();
+	TruthValuePtr tv = _rules.update_tv(rule.get_alias(), success, not success);
+	if (tv)
+		LAZY_URE_LOG_FINE << "Update TV of " << rule.get_name()
+		                  << " to " << tv->to_string();
+}
+
+void ForwardChainer::save_rule_tvs()
+{
+	if (not _config.get_rule_tv_persistence())
+		return;
+
+	std::lock_guard<std::mutex> lock(_rules_mutex);
+	_rules.save_tvs();
+	ure_logger().debug() << "Rule TVs have been saved to the rule base";
+}
+
 void ForwardChainer::validate(const Handle& source)
 {
 	if (source == Handle::UNDEFINED)
@@ -28,6 +28,9 @@
 // #include <shared_mutex>
 
 #include "../UREConfig.h"
+#include "../ResultStream.h"
+#include "../UREBudget.h"
+#include "../CancellationToken.h"
 #include "SourceSet.h"
 #include "SourceRuleSet.h"
 #include "FCStat.h"
@@ -94,6 +97,62 @@ public:
 	 */
 	void do_chain();
 
+	/**
+	 * Perform forward chaining inference for at most max_steps
+	 * iterations and max_ms milliseconds, negative meaning
+	 * unlimited, or till the termination criteria have been met.
+	 *
+	 * It can be called repeatedly to resume chaining where it was
+	 * left, all state being kept in between. The time spent between
+	 * calls does not count toward the time budget.
+	 *
+	 * @return true iff the termination criteria have been met, in
+	 *         which case chaining is over, as after do_chain(), and
+	 *         subsequent calls do nothing.
+	 */
+	bool run(int max_steps, int max_ms=-1);
+
+	/**
+	 * Return true iff chaining is over.
+	 */
+	bool is_finished() const;
+
+	/**
+	 * Write the chaining state to filename, so that it can be resumed
+	 * later, possibly by another process, with load_checkpoint. That
+	 * is the rules of the rule base, the iteration, the sources with
+	 * their tried rules, the (source, rule) pairs, the rule TVs and
+	 * the inference records.
+	 *
+	 * The file is written to filename.tmp then renamed, so that a
+	 * crash during saving does not corrupt a previous checkpoint.
+	 */
+	void save_checkpoint(const std::string& filename) const;
+
+	/**
+	 * Restore the chaining state saved by save_checkpoint, before
+	 * starting chaining, then call run() or do_chain() to resume.
+	 *
+	 * The chainer must have been constructed with the same rule base
+	 * and knowledge base, the products of the checkpointed chaining
+	 * being expected to be in the knowledge base. Source weights are
+	 * recalculated from the current truth values, the random generator
+	 * state is not restored and the time budget starts over.
+	 *
+	 * Throw a RuntimeException if chaining has already started or the
+	 * checkpoint is ill-formed or of another rule base, or of rules
+	 * with other aliases or bodies.
+	 */
+	void load_checkpoint(const std::string& filename);
+
+	/**
+	 * Save a checkpoint to filename every period iterations during
+	 * chaining, 0 meaning never. When multithreaded, the steps are
+	 * let finish before each checkpoint, which may then be a few
+	 * iterations late.
+	 */
+	void set_checkpoint(const std::string& filename, int period);
+
 	/**
 	 * run steps (single or multi threaded) until termination criteria
 	 * are met.
@@ -101,6 +160,13 @@ public:
 	void do_steps_singlethread();
 	void do_steps_multithread();
 
+	/**
+	 * Run steps in parallel until termination criteria are met or
+	 * the iteration round_end is reached, then wait for the running
+	 * steps to finish.
+	 */
+	void do_steps_multithread(int round_end);
+
 	/**
 	 * Source rule producer implementation of do_steps.
 	 */
@@ -119,6 +185,12 @@ public:
 
 	/**
 	 * @return true if the termination criteria have been met.
+	 *
+	 * More specifically, either
+	 * 1. has been cancelled,
+	 * 2. or all source rule pairs have been exhausted,
+	 * 3. or reached the maximum number of iterations,
+	 * 4. or exceeded the time, atoms created or memory budget.
 	 */
 	bool termination();
 
@@ -127,12 +199,39 @@ public:
 	 */
 	void termination_log();
 
+	/**
+	 * Request the chaining to stop. Can be called from any thread,
+	 * do_chain() then returns once the steps in progress are over,
+	 * with the results found so far.
+	 */
+	void cancel();
+	bool is_cancelled() const;
+
+	/**
+	 * Replace the cancellation token, for instance to share it with
+	 * other chainers, see CancellationToken.
+	 */
+	void set_cancellation_token(const CancellationTokenPtr& token);
+	const CancellationTokenPtr& get_cancellation_token() const;
+
+	/**
+	 * Number of iterations started so far. Can be called from any
+	 * thread, to monitor progress.
+	 */
+	int get_iteration() const;
+
 	/**
 	 * @return all results in their order of inference.
 	 */
 	Handle get_results() const;
 	HandleSet get_results_set() const;
 
+	/**
+	 * Stream delivering each new product as soon as it is derived,
+	 * see ResultStream. It is closed at the end of do_chain().
+	 */
+	ResultStream& get_result_stream();
+
 private:
 	friend class ::ForwardChainerUTest;
 
@@ -140,6 +239,15 @@ private:
 	          const Handle& vardecl,
 	          const HandleSeq& focus_set);
 
+	// Set up chaining, called by the first run()
+	void start_chain();
+
+	// Wrap up chaining, called by the last run()
+	void finish_chain();
+
+	// Save a checkpoint if one is due, see set_checkpoint
+	void periodic_checkpoint();
+
 	void apply_all_rules();
 
 	void validate(const Handle& source);
@@ -212,6 +320,26 @@ private:
 	HandleSet apply_rule(const Rule& rule);
 	HandleSet apply_rule(const SourceRule& sr);
 
+	/**
+	 * Save the trace and results of a rule application, stream the
+	 * new products, and learn from its outcome.
+	 */
+	void record_inference(int iteration, const Handle& source,
+	                      const Rule& rule, const HandleSet& products);
+
+	/**
+	 * Update the TV of the given rule according to whether its
+	 * application has produced anything, see
+	 * UREConfig::get_rule_tv_learning.
+	 */
+	void update_rule_tv(const Rule& rule, const HandleSet& products);
+
+	/**
+	 * Write the rule TVs back to the rule base, if enabled, see
+	 * UREConfig::get_rule_tv_persistence.
+	 */
+	void save_rule_tvs();
+
 	RuleSet _rules; /* loaded rules */
 
 	// Knowledge base atomspace
@@ -227,13 +355,31 @@ private:
 	// perhaps there is some better mechanism?
 	AtomSpace _focus_set_as;
 
+	// Holds the specialized rules loaded by load_checkpoint, for the
+	// lifetime of the chainer.
+	AtomSpace _checkpoint_as;
+
 	UREConfig _config;
 
+	// Keep track of time, atoms and memory budgets
+	UREBudget _budget;
+
 	// Current iteration
 	std::atomic<int> _iteration;
 
+	// Raised by cancel()
+	CancellationTokenPtr _cancellation;
+
+	// Whether chaining has started and is over, see run()
+	bool _started;
+	bool _finished;
+
 	bool _search_focus_set;
 
+	// Periodic checkpoints, see set_checkpoint
+	std::string _checkpoint_file;
+	int _checkpoint_period;
+
 	// TODO: subdivide in smaller and shared mutexes
 	mutable std::mutex _whole_mutex;
 	mutable std::mutex _part_mutex;
@@ -249,6 +395,9 @@ private:
 
 	FCStat _fcstat;
 
+	// Stream of results, delivered as they are derived
+	ResultStream _result_stream;
+
 	// Enable alternative implementation using (source, rule) producer,
 	// srpi stands for Source Rule Producer Implementation. This flag
 	// is here, likely temporarily, to compare old and new way.
@@ -22,9 +22,13 @@
 
 #include "SourceRuleSet.h"
 
+#include <algorithm>
+#include <map>
+
 #include <boost/range/algorithm/lower_bound.hpp>
 #include <boost/algorithm/cxx11/all_of.hpp>
 
+#include <opencog/util/exceptions.h>
 #include <opencog/util/oc_assert.h>
 
 namespace opencog {
@@ -112,6 +116,53 @@ size_t SourceRuleSet::size() const
 	return source_rule_seq.size();
 }
 
+void SourceRuleSet::save(RuleBaseWriter& writer, const SourceSet& sources) const
+{
+	// Index the sources, and the tried rules of each source, once
+	// rather than searching them for every pair
+	std::map<const Source*, uint32_t> src_indices;
+	std::map<std::pair<const Source*, const Rule*>, uint32_t> rule_indices;
+	const SourceSet::Sources& srcs = sources.sources;
+	for (uint32_t i = 0; i < srcs.size(); i++) {
+		const Source* src = srcs[i].get();
+		src_indices.emplace(src, i);
+		for (uint32_t j = 0; j < src->rules.size(); j++)
+			rule_indices.emplace(std::make_pair(src, src->rules[j].get()), j);
+	}
+
+	writer.put_uint(source_rule_seq.size());
+	for (size_t i = 0; i < source_rule_seq.size(); i++) {
+		const SourceRule& sr = source_rule_seq[i];
+		auto src_it = src_indices.find(sr.source.get());
+		auto rule_it = rule_indices.find({sr.source.get(), sr.rule.get()});
+		OC_ASSERT(src_it != src_indices.end()
+		          and rule_it != rule_indices.end());
+		writer.put_uint(src_it->second);
+		writer.put_uint(rule_it->second);
+		writer.put_tv(tv_seq[i]);
+	}
+}
+
+void SourceRuleSet::load(RuleBaseReader& reader, const SourceSet& sources)
+{
+	const SourceSet::Sources& srcs = sources.sources;
+	source_rule_seq.clear();
+	tv_seq.clear();
+	uint32_t size = reader.get_uint();
+	for (uint32_t i = 0; i < size; i++) {
+		uint32_t src_idx = reader.get_uint();
+		uint32_t rule_idx = reader.get_uint();
+		if (srcs.size() <= src_idx or srcs[src_idx]->rules.size() <= rule_idx)
+			throw RuntimeException(TRACE_INFO,
+				"SourceRuleSet - invalid (source, rule) pair in checkpoint");
+
+		// Pairs have been saved in order
+		const SourcePtr& src = srcs[src_idx];
+		source_rule_seq.emplace_back(src, src->rules[rule_idx]);
+		tv_seq.push_back(reader.get_tv());
+	}
+}
+
 std::string SourceRuleSet::to_string(const std::string& indent) const
 {
 	std::stringstream ss;
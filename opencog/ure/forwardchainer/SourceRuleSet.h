@@ -112,6 +112,20 @@ public:
 	 */
 	size_t size() const;
 
+	/**
+	 * Write the pairs and their TVs to a checkpoint, see
+	 * ForwardChainer::save_checkpoint. Sources and rules are referred
+	 * to by their indices in sources and in the tried rules of their
+	 * source.
+	 */
+	void save(RuleBaseWriter& writer, const SourceSet& sources) const;
+
+	/**
+	 * Replace the pairs by the ones read from a checkpoint, given the
+	 * sources loaded from it.
+	 */
+	void load(RuleBaseReader& reader, const SourceSet& sources);
+
 	/**
 	 * Turn the source rule pool into a string representation. Useful
 	 * for debugging.
@@ -22,9 +22,12 @@
 
 #include "SourceSet.h"
 
+#include <algorithm>
+
 #include <boost/range/algorithm/binary_search.hpp>
 #include <boost/range/algorithm/lower_bound.hpp>
 
+#include <opencog/util/exceptions.h>
 #include <opencog/util/numeric.h>
 #include <opencog/atoms/core/VariableSet.h>
 
@@ -264,6 +267,73 @@ bool SourceSet::empty() const
 	return sources.empty();
 }
 
+void SourceSet::save(RuleBaseWriter& writer) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	writer.put_bool(exhausted);
+	writer.put_uint(sources.size());
+	for (const SourcePtr& src : sources) {
+		writer.put_atom(src->body);
+		writer.put_bool((bool)src->vardecl);
+		if (src->vardecl)
+			writer.put_atom(src->vardecl);
+		writer.put_double(src->complexity);
+		writer.put_double(src->complexity_factor);
+		writer.put_bool(src->exhausted);
+
+		// Tried rules are usually specializations of the rules of the
+		// rule base, thus are saved in full.
+		writer.put_uint(src->rules.size());
+		for (const RulePtr& rule : src->rules) {
+			writer.put_atom(rule->get_alias());
+			writer.put_atom(rule->get_rule());
+			writer.put_bool(rule->is_exhausted());
+		}
+	}
+}
+
+void SourceSet::load(RuleBaseReader& reader, const RuleSet& rules,
+                     AtomSpace& kb_as)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	exhausted = reader.get_bool();
+	sources.clear();
+	uint32_t source_count = reader.get_uint();
+	for (uint32_t i = 0; i < source_count; i++) {
+		Handle body = reader.get_atom(kb_as);
+		Handle vardecl = reader.get_bool() ? reader.get_atom(kb_as)
+			: Handle::UNDEFINED;
+		double complexity = reader.get_double();
+		double complexity_factor = reader.get_double();
+		SourcePtr src = createSource(body, vardecl, complexity, complexity_factor);
+		src->exhausted = reader.get_bool();
+
+		uint32_t rule_count = reader.get_uint();
+		for (uint32_t j = 0; j < rule_count; j++) {
+			Handle alias = reader.get_atom();
+			Handle rule_h = reader.get_atom();
+			auto base = std::find_if(rules.begin(), rules.end(),
+			                         [&](const RulePtr& r) {
+				                         return r->get_name() == alias->get_name(); });
+			if (base == rules.end())
+				throw RuntimeException(TRACE_INFO,
+					"SourceSet - the rule %s of the checkpoint is not in the "
+					"rule base", alias->get_name().c_str());
+
+			RulePtr rule = createRule(**base);
+			rule->set_rule(rule_h);
+			if (reader.get_bool())
+				rule->set_exhausted();
+			else
+				rule->reset_exhausted();
+			src->rules.insert(rule);
+		}
+
+		// Sources have been saved in order
+		sources.push_back(src);
+	}
+}
+
 std::string SourceSet::to_string(const std::string& indent) const
 {
 	std::lock_guard<std::mutex> lock(_mutex);
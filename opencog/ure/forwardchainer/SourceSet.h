@@ -35,6 +35,7 @@
 
 #include "../Rule.h"
 #include "../UREConfig.h"
+#include "../RuleBaseFile.h"
 
 namespace opencog
 {
@@ -205,6 +206,21 @@ public:
 
 	bool empty() const;
 
+	/**
+	 * Write the sources, with their complexities, exhausted flags and
+	 * tried rules, to a checkpoint, see
+	 * ForwardChainer::save_checkpoint.
+	 */
+	void save(RuleBaseWriter& writer) const;
+
+	/**
+	 * Replace the sources by the ones read from a checkpoint. Tried
+	 * rules are rebuilt from the rules of the same name in rules, the
+	 * rule set of the chainer. Throw a RuntimeException if some are
+	 * missing. Source bodies and vardecls are copied into kb_as.
+	 */
+	void load(RuleBaseReader& reader, const RuleSet& rules, AtomSpace& kb_as);
+
 	std::string to_string(const std::string& indent=empty_string) const;
 
 	// Collection of sources. We use a sorted vector instead of a set
@@ -3,7 +3,7 @@ import unittest
 from unittest import TestCase
 from opencog.scheme_wrapper import scheme_eval
 from opencog.atomspace import TruthValue
-from opencog.ure import BackwardChainer
+from opencog.ure import BackwardChainer, BatchBackwardChainer
 from opencog.type_constructors import *
 from opencog.utilities import initialize_opencog, finalize_opencog
 import __main__
@@ -86,6 +86,110 @@ class BCTest(TestCase):
         self.assertEquals("C", resultAC.get_out()[1].name)
         del chainer
 
+    def test_bc_batch_deduction(self):
+        self.init()
+
+        scheme_eval(self.atomspace, '(use-modules (opencog))')
+        scheme_eval(self.atomspace, '(use-modules (opencog exec))')
+        scheme_eval(self.atomspace, '(use-modules (opencog ure))')
+        scheme_eval(self.atomspace, '(load-from-path "bc-deduction-config.scm")')
+
+        A = ConceptNode("A", TruthValue(1, 1))
+        B = ConceptNode("B")
+        C = ConceptNode("C")
+        InheritanceLink(A, B).tv = TruthValue(1, 1)
+        InheritanceLink(B, C).tv = TruthValue(1, 1)
+        who = VariableNode("$who")
+        vardecl = TypedVariableLink(who, TypeNode("ConceptNode"))
+
+        chainer = BatchBackwardChainer(self.atomspace,
+                                       ConceptNode("URE"),
+                                       [InheritanceLink(who, C),
+                                        InheritanceLink(A, C)],
+                                       [vardecl, None],
+                                       jobs=2)
+        self.assertEqual(2, len(chainer))
+        chainer.do_chain()
+        results = chainer.get_results()
+        self.assertEqual(2, len(results))
+        self.assertTrue(InheritanceLink(A, C) in results[0])
+        self.assertEqual([InheritanceLink(A, C)], results[1])
+        del chainer
+
+    def test_bc_async_deduction(self):
+        self.init()
+
+        scheme_eval(self.atomspace, '(use-modules (opencog))')
+        scheme_eval(self.atomspace, '(use-modules (opencog exec))')
+        scheme_eval(self.atomspace, '(use-modules (opencog ure))')
+        scheme_eval(self.atomspace, '(load-from-path "bc-deduction-config.scm")')
+
+        A = ConceptNode("A", TruthValue(1, 1))
+        B = ConceptNode("B")
+        C = ConceptNode("C")
+        InheritanceLink(A, B).tv = TruthValue(1, 1)
+        InheritanceLink(B, C).tv = TruthValue(1, 1)
+
+        chainer = BackwardChainer(self.atomspace,
+                                  ConceptNode("URE"),
+                                  InheritanceLink(A, C))
+        task = chainer.do_chain_async(stream=True)
+        results = task.result(timeout=60)
+        self.assertTrue(task.done())
+        self.assertFalse(task.cancelled())
+        self.assertEqual([InheritanceLink(A, C)], results)
+        iterations, streamed = task.progress()
+        self.assertEqual(chainer.get_iteration(), iterations)
+        self.assertEqual(results, streamed)
+        del task
+        del chainer
+
+    def test_bc_async_no_stream(self):
+        self.init()
+
+        scheme_eval(self.atomspace, '(use-modules (opencog))')
+        scheme_eval(self.atomspace, '(use-modules (opencog exec))')
+        scheme_eval(self.atomspace, '(use-modules (opencog ure))')
+        scheme_eval(self.atomspace, '(load-from-path "bc-deduction-config.scm")')
+
+        A = ConceptNode("A", TruthValue(1, 1))
+        B = ConceptNode("B")
+        C = ConceptNode("C")
+        InheritanceLink(A, B).tv = TruthValue(1, 1)
+        InheritanceLink(B, C).tv = TruthValue(1, 1)
+
+        chainer = BackwardChainer(self.atomspace,
+                                  ConceptNode("URE"),
+                                  InheritanceLink(A, C))
+        task = chainer.do_chain_async()
+        results = task.result(timeout=60)
+        self.assertEqual([InheritanceLink(A, C)], results)
+        # Nothing has been queued, results are listed once done
+        self.assertIsNone(chainer.pop_result(0))
+        iterations, listed = task.progress()
+        self.assertEqual(results, listed)
+        del task
+        del chainer
+
+    def test_bc_cancel(self):
+        self.init()
+
+        scheme_eval(self.atomspace, '(use-modules (opencog))')
+        scheme_eval(self.atomspace, '(use-modules (opencog exec))')
+        scheme_eval(self.atomspace, '(use-modules (opencog ure))')
+        scheme_eval(self.atomspace, '(load-from-path "bc-deduction-config.scm")')
+
+        chainer = BackwardChainer(self.atomspace,
+                                  ConceptNode("URE"),
+                                  InheritanceLink(ConceptNode("A"),
+                                                  ConceptNode("C")))
+        chainer.cancel()
+        chainer.do_chain()
+        self.assertTrue(chainer.is_cancelled())
+        self.assertEqual(0, chainer.get_iteration())
+        self.assertEqual([], chainer.get_results_list())
+        del chainer
+
     def test_conjunction_fuzzy_with_virtual_evaluation(self):
         """Test for correct vardecl parameter initialization in BackwardChainer
 